@@ -0,0 +1,39 @@
+#!/bin/bash
+
+help() {
+    echo "Usage: bench.sh [options]"
+    echo
+    echo "Runs the benchmarks built by build.sh and prints the results as JSON."
+    echo "Any option other than the ones below is passed to 46ProjectBench."
+    echo
+    echo "Options:"
+    echo "  -sizes=<n,...>         Key counts to run, e.g. -sizes=1000,100000000"
+    echo "  -out=<path>            Write the JSON results to path"
+    echo "  -compare               Run the regression gate against bench/baseline.json"
+    echo "  -help [-h]             Displays this message"
+}
+
+new_args=()
+for arg in "$@"; do
+    if [[ $arg = -sizes=* ]]; then
+        new_args+=("--sizes=${arg#*=}")
+    elif [ "$arg" == "-compare" ]; then
+        new_args+=("--compare=$(readlink -fn "$(dirname "$0")")/bench/baseline.json")
+    elif [[ $arg = -out=* ]]; then
+        new_args+=("--out=${arg#*=}")
+    elif [ "$arg" == "-help" ] || [ "$arg" == "-h" ]; then
+        help
+        exit 0
+    else
+        new_args+=("$arg")
+    fi
+done
+
+SCRIPT_DIR=$(readlink -fn "$(dirname "$0")")
+
+if [ -e "$SCRIPT_DIR/build/46ProjectBench" ]; then
+    "$SCRIPT_DIR/build/46ProjectBench" "${new_args[@]}"
+else
+    echo "Could not find $SCRIPT_DIR/build/46ProjectBench; have you successfully built?"
+    exit 1
+fi
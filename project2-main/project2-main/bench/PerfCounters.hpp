@@ -0,0 +1,121 @@
+#ifndef ___PERF_COUNTERS_HPP
+#define ___PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Hardware counters for the calling thread, read through Linux's
+ * perf_event_open.
+ *
+ * Each counter is opened on its own rather than as a group, so a machine
+ * (or VM, or container) that lacks one still reports the rest. Counters
+ * that cannot be opened are left out; on anything but Linux, or when
+ * perf_event_paranoid forbids it, there are none and available() is false.
+ * Only user-space events are counted. When the kernel multiplexes more
+ * counters than the PMU has, counts are scaled up by enabled/running time.
+ */
+class PerfCounters {
+   public:
+    PerfCounters() {
+#ifdef __linux__
+        open("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open("cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open("llc_misses", PERF_TYPE_HW_CACHE,
+             PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        open("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        open("dtlb_misses", PERF_TYPE_HW_CACHE,
+             PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (const Counter& counter : counters) {
+            ::close(counter.fd);
+        }
+#endif
+    }
+
+    [[nodiscard]] bool available() const noexcept { return not counters.empty(); }
+
+    // Names of the counters that opened, in the order stop() reports them
+    [[nodiscard]] std::vector<std::string> names() const {
+        std::vector<std::string> result;
+        for (const Counter& counter : counters) {
+            result.push_back(counter.name);
+        }
+        return result;
+    }
+
+    void start() {
+#ifdef __linux__
+        for (const Counter& counter : counters) {
+            ::ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Counts since start(), one per name()
+    std::vector<double> stop() {
+        std::vector<double> counts;
+#ifdef __linux__
+        for (const Counter& counter : counters) {
+            ::ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (const Counter& counter : counters) {
+            uint64_t values[3]{0, 0, 0};  // value, time enabled, time running
+            double count{0};
+            if (::read(counter.fd, values, sizeof(values)) == sizeof(values) and
+                values[2] > 0) {
+                count = static_cast<double>(values[0]) * static_cast<double>(values[1]) /
+                        static_cast<double>(values[2]);
+            }
+            counts.push_back(count);
+        }
+#endif
+        return counts;
+    }
+
+   private:
+    struct Counter {
+        std::string name;
+        int fd;
+    };
+    std::vector<Counter> counters;
+
+#ifdef __linux__
+    void open(const std::string& name, uint32_t type, uint64_t config) {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format =
+            PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        long fd{::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0)};
+        if (fd >= 0) {
+            counters.push_back({name, static_cast<int>(fd)});
+        }
+    }
+#endif
+};
+
+#endif
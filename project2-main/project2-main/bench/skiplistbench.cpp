@@ -0,0 +1,976 @@
+#include <CompactSkipList.hpp>
+#include <SimdSkipList.hpp>
+#include <SkipList.hpp>
+#include <UnrolledSkipList.hpp>
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "PerfCounters.hpp"
+
+namespace {
+// Bytes currently allocated through operator new, for bytes/key
+std::atomic<int64_t> liveBytes{0};
+
+// Each allocation is prefixed with its size so the unsized delete can
+// account for it; the prefix keeps the default new alignment.
+const size_t ALLOCATION_PREFIX = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}  // namespace
+
+// Kept out of line: inlined into container code, gcc's bounds checks see
+// the size prefix as an access before the allocation
+__attribute__((noinline)) void* operator new(size_t bytes) {
+    auto* block = static_cast<char*>(std::malloc(bytes + ALLOCATION_PREFIX));
+    if (block == nullptr) {
+        throw std::bad_alloc{};
+    }
+    *reinterpret_cast<size_t*>(block) = bytes;
+    liveBytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    return block + ALLOCATION_PREFIX;
+}
+
+// gcc takes the free below for a mismatched delete of the new'd pointer
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+__attribute__((noinline)) void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    char* block = static_cast<char*>(pointer) - ALLOCATION_PREFIX;
+    liveBytes.fetch_sub(static_cast<int64_t>(*reinterpret_cast<size_t*>(block)),
+                        std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+/*
+Throughput benchmark comparing SkipList, CompactSkipList,
+UnrolledSkipList and, for integer keys, SimdSkipList with std::map, a sorted std::vector and
+std::unordered_map. For string keys SkipList also runs with ABBREVIATE_KEYS
+off ("plainkeys"), on keys sharing a long prefix (string) and on keys that
+differ early (text).
+
+Every container gets the same keys in the same shuffled order. Lookups
+and erases are timed over a sample of at most LOOKUP_SAMPLE keys so that
+large sizes finish in reasonable time. Conventions that differ between
+containers:
+
+  - SkipList find-miss uses contains(), since find() throws on a miss.
+  - The sorted vector is filled by appending and sorting once at the end,
+    the way one is normally built; its erase is a real O(n) erase, so it
+    only erases VECTOR_ERASE_SAMPLE keys.
+  - std::unordered_map has no order, so it skips nextKey and
+    allKeysInOrder.
+
+Results are printed as JSON on stdout (or to --out), one object per
+container, type, size and operation. Insert results also carry the heap
+bytes per key the container held once filled. SkipList workloads add a
+search_cost entry: hops and comparisons per find, counted on a separate
+list built with CountingSkipListTraits, next to log_2 n.
+
+On Linux, each result also carries hardware counters per operation
+(instructions, cache, LLC, branch and dTLB misses) read through
+perf_event_open, when the kernel allows it; see PerfCounters.hpp. The
+regression gate does not read them.
+
+UnrolledSkipList searches blocks of integer keys with whichever vector
+instructions the build targets (KeySearch.hpp); configure with
+-DSHINDLER_ICS46_BENCH_NATIVE=ON to build for this machine's, e.g. AVX2.
+
+--compare=<baseline> is the regression gate: it runs the fixed
+COMPARE_SIZES x COMPARE_TYPES workloads against SkipList and exits
+non-zero if any figure --metrics picks is more than --threshold percent
+worse than the baseline's. bytes/key (--metrics=memory, the default)
+counts what the code asks the allocator for, so it gives the same answer
+on any machine and is what the default ctest run checks. ns/op
+(--metrics=time or all) only means something against a baseline recorded
+on the same host, so its ctest only exists when configured with
+-DSHINDLER_ICS46_BENCH_TIMING_GATE=ON and carries the "timing" label.
+Timings keep the best of COMPARE_REPEATS runs, and a failing comparison
+is rerun up to COMPARE_ROUNDS times first, so a burst of noise on a busy
+machine does not fail the gate on its own. --write-baseline=<path>
+records a new baseline from the same workloads.
+*/
+
+const size_t LOOKUP_SAMPLE = 1000000;
+const size_t ERASE_SAMPLE = 10000;
+const size_t VECTOR_ERASE_SAMPLE = 100;
+const uint64_t SEED = 46;
+
+const std::vector<size_t> COMPARE_SIZES{1000, 10000};
+const std::vector<std::string> COMPARE_TYPES{"unsigned", "string"};
+const size_t COMPARE_REPEATS = 11;
+const size_t COMPARE_ROUNDS = 3;
+const double DEFAULT_THRESHOLD_PERCENT = 25.0;
+
+// Figures --compare checks
+enum class Metrics { Memory, Time, All };
+
+// Progress lines on stderr; the gate turns them off
+bool verbose = true;
+
+// How std::string keys are spelled: "key" and a zero-padded number, so
+// every key shares its first eight bytes, or the hex digits of a hash of
+// the number, so keys already differ in the first byte or two (--types=text)
+enum class StringKeys { SharedPrefix, Scattered };
+StringKeys stringKeys = StringKeys::SharedPrefix;
+
+// Value type for the large-value workloads
+struct LargeValue {
+    std::array<unsigned char, 1024> bytes{};
+};
+
+struct Result {
+    std::string container;
+    std::string keyType;
+    std::string valueType;
+    size_t size;
+    std::string operation;
+    size_t ops;
+    double nsPerOp;
+    // Only measured for inserts, 0 elsewhere
+    double bytesPerKey{0};
+    // Hardware counter name and count per operation, when perf counters
+    // are available
+    std::vector<std::pair<std::string, double>> countersPerOp{};
+};
+
+// Average work per SkipList find, from a counting copy of the list,
+// against log_{1/p} n = log_2 n since each coin flip is one key bit
+struct SearchCost {
+    std::string keyType;
+    std::string valueType;
+    size_t size;
+    size_t lookups;
+    double hopsPerLookup;
+    double comparisonsPerLookup;
+    double expectedHops;
+};
+
+std::vector<SearchCost> searchCosts;
+// The regression gate skips the counting pass
+bool measureSearchCost = true;
+
+// Anything folded in here cannot be optimized away
+volatile uint64_t sink = 0;
+
+template <typename T>
+void consume(const T& item) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        sink = sink + item.size();
+    } else if constexpr (std::is_same_v<T, LargeValue>) {
+        sink = sink + item.bytes[0];
+    } else {
+        sink = sink + static_cast<uint64_t>(item);
+    }
+}
+
+// Opened once; null when --no-perf is given
+std::unique_ptr<PerfCounters> perf;
+
+struct Measurement {
+    double ns;
+    std::vector<double> counters;
+};
+
+template <typename F>
+Measurement measure(F&& work) {
+    if (perf) {
+        perf->start();
+    }
+    auto start = std::chrono::steady_clock::now();
+    work();
+    auto stop = std::chrono::steady_clock::now();
+    Measurement measurement{
+        static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()),
+        {}};
+    if (perf) {
+        measurement.counters = perf->stop();
+    }
+    return measurement;
+}
+
+// Even numbers are inserted, odd numbers are guaranteed misses
+template <typename K>
+K makeKey(uint64_t i);
+
+template <>
+unsigned makeKey<unsigned>(uint64_t i) {
+    return static_cast<unsigned>(i * 2);
+}
+
+template <>
+std::string makeKey<std::string>(uint64_t i) {
+    char buffer[32];
+    if (stringKeys == StringKeys::Scattered) {
+        // splitmix64's finalizer, which is one-to-one, so keys stay distinct
+        uint64_t hash{i * 2};
+        hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+        hash ^= hash >> 31;
+        std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "key%012llu",
+                      static_cast<unsigned long long>(i * 2));
+    }
+    return buffer;
+}
+
+template <typename V>
+V makeValue(uint64_t i) {
+    if constexpr (std::is_same_v<V, LargeValue>) {
+        LargeValue value;
+        value.bytes[0] = static_cast<unsigned char>(i);
+        return value;
+    } else if constexpr (std::is_same_v<V, std::string>) {
+        return std::to_string(i);
+    } else {
+        return static_cast<V>(i);
+    }
+}
+
+template <typename K, typename V>
+struct SkipListAdapter {
+    static constexpr const char* NAME = "SkipList";
+    static constexpr bool ORDERED = true;
+    static constexpr size_t ERASES = ERASE_SAMPLE;
+    proj2::SkipList<K, V> list;
+
+    void insert(const K& key, const V& value) { list.insert(key, value); }
+    void finishInserts() {}
+    const V& findHit(const K& key) { return list.find(key); }
+    bool findMiss(const K& key) { return list.contains(key); }
+    const K& nextKey(const K& key) { return list.nextKey(key); }
+    std::vector<K> allKeysInOrder() { return list.allKeysInOrder(); }
+    template <typename F>
+    void forEach(F&& fn) {
+        for (auto [key, value] : list) {
+            fn(key, value);
+        }
+    }
+    void erase(const K& key) { list.erase(key); }
+};
+
+struct PlainKeysTraits : proj2::SkipListTraits {
+    static constexpr bool ABBREVIATE_KEYS{false};
+};
+
+// SkipList whose index nodes keep no prefix of a string key, to weigh
+// ABBREVIATE_KEYS against
+template <typename K, typename V>
+struct PlainKeysSkipListAdapter {
+    static constexpr const char* NAME = "SkipList(plain keys)";
+    static constexpr bool ORDERED = true;
+    static constexpr size_t ERASES = ERASE_SAMPLE;
+    proj2::SkipList<K, V, PlainKeysTraits> list;
+
+    void insert(const K& key, const V& value) { list.insert(key, value); }
+    void finishInserts() {}
+    const V& findHit(const K& key) { return list.find(key); }
+    bool findMiss(const K& key) { return list.contains(key); }
+    const K& nextKey(const K& key) { return list.nextKey(key); }
+    std::vector<K> allKeysInOrder() { return list.allKeysInOrder(); }
+    template <typename F>
+    void forEach(F&& fn) {
+        for (auto [key, value] : list) {
+            fn(key, value);
+        }
+    }
+    void erase(const K& key) { list.erase(key); }
+};
+
+template <typename K, typename V>
+struct CompactSkipListAdapter {
+    static constexpr const char* NAME = "CompactSkipList";
+    static constexpr bool ORDERED = true;
+    static constexpr size_t ERASES = ERASE_SAMPLE;
+    proj2::CompactSkipList<K, V> list;
+
+    void insert(const K& key, const V& value) { list.insert(key, value); }
+    void finishInserts() {}
+    const V& findHit(const K& key) { return list.find(key); }
+    bool findMiss(const K& key) { return list.contains(key); }
+    const K& nextKey(const K& key) { return list.nextKey(key); }
+    std::vector<K> allKeysInOrder() { return list.allKeysInOrder(); }
+    template <typename F>
+    void forEach(F&& fn) {
+        for (auto [key, value] : list) {
+            fn(key, value);
+        }
+    }
+    void erase(const K& key) { list.erase(key); }
+};
+
+template <typename K, typename V>
+struct UnrolledSkipListAdapter {
+    static constexpr const char* NAME = "UnrolledSkipList";
+    static constexpr bool ORDERED = true;
+    static constexpr size_t ERASES = ERASE_SAMPLE;
+    proj2::UnrolledSkipList<K, V> list;
+
+    void insert(const K& key, const V& value) { list.insert(key, value); }
+    void finishInserts() {}
+    const V& findHit(const K& key) { return list.find(key); }
+    bool findMiss(const K& key) { return list.contains(key); }
+    const K& nextKey(const K& key) { return list.nextKey(key); }
+    std::vector<K> allKeysInOrder() { return list.allKeysInOrder(); }
+    template <typename F>
+    void forEach(F&& fn) {
+        for (auto [key, value] : list) {
+            fn(key, value);
+        }
+    }
+    void erase(const K& key) { list.erase(key); }
+};
+
+template <typename K, typename V>
+struct SimdSkipListAdapter {
+    static constexpr const char* NAME = "SimdSkipList";
+    static constexpr bool ORDERED = true;
+    static constexpr size_t ERASES = ERASE_SAMPLE;
+    proj2::SimdSkipList<K, V> list;
+
+    void insert(const K& key, const V& value) { list.insert(key, value); }
+    void finishInserts() {}
+    const V& findHit(const K& key) { return list.find(key); }
+    bool findMiss(const K& key) { return list.contains(key); }
+    const K& nextKey(const K& key) { return list.nextKey(key); }
+    std::vector<K> allKeysInOrder() { return list.allKeysInOrder(); }
+    template <typename F>
+    void forEach(F&& fn) {
+        for (auto [key, value] : list) {
+            fn(key, value);
+        }
+    }
+    void erase(const K& key) { list.erase(key); }
+};
+
+template <typename K, typename V>
+struct MapAdapter {
+    static constexpr const char* NAME = "std::map";
+    static constexpr bool ORDERED = true;
+    static constexpr size_t ERASES = ERASE_SAMPLE;
+    std::map<K, V> map;
+
+    void insert(const K& key, const V& value) { map.emplace(key, value); }
+    void finishInserts() {}
+    const V& findHit(const K& key) { return map.find(key)->second; }
+    bool findMiss(const K& key) { return map.find(key) != map.end(); }
+    const K& nextKey(const K& key) { return std::next(map.find(key))->first; }
+    std::vector<K> allKeysInOrder() {
+        std::vector<K> keys;
+        keys.reserve(map.size());
+        for (const auto& [key, value] : map) {
+            keys.push_back(key);
+        }
+        return keys;
+    }
+    template <typename F>
+    void forEach(F&& fn) {
+        for (const auto& [key, value] : map) {
+            fn(key, value);
+        }
+    }
+    void erase(const K& key) { map.erase(key); }
+};
+
+template <typename K, typename V>
+struct SortedVectorAdapter {
+    static constexpr const char* NAME = "sorted std::vector";
+    static constexpr bool ORDERED = true;
+    static constexpr size_t ERASES = VECTOR_ERASE_SAMPLE;
+    std::vector<std::pair<K, V>> entries;
+
+    typename std::vector<std::pair<K, V>>::iterator position(const K& key) {
+        return std::lower_bound(
+            entries.begin(), entries.end(), key,
+            [](const std::pair<K, V>& entry, const K& k) { return entry.first < k; });
+    }
+
+    void insert(const K& key, const V& value) { entries.emplace_back(key, value); }
+    void finishInserts() {
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    }
+    const V& findHit(const K& key) { return position(key)->second; }
+    bool findMiss(const K& key) {
+        auto it = position(key);
+        return it != entries.end() and it->first == key;
+    }
+    const K& nextKey(const K& key) { return std::next(position(key))->first; }
+    std::vector<K> allKeysInOrder() {
+        std::vector<K> keys;
+        keys.reserve(entries.size());
+        for (const auto& entry : entries) {
+            keys.push_back(entry.first);
+        }
+        return keys;
+    }
+    template <typename F>
+    void forEach(F&& fn) {
+        for (const auto& [key, value] : entries) {
+            fn(key, value);
+        }
+    }
+    void erase(const K& key) { entries.erase(position(key)); }
+};
+
+template <typename K, typename V>
+struct UnorderedMapAdapter {
+    static constexpr const char* NAME = "std::unordered_map";
+    static constexpr bool ORDERED = false;
+    static constexpr size_t ERASES = ERASE_SAMPLE;
+    std::unordered_map<K, V> map;
+
+    void insert(const K& key, const V& value) { map.emplace(key, value); }
+    void finishInserts() {}
+    const V& findHit(const K& key) { return map.find(key)->second; }
+    bool findMiss(const K& key) { return map.find(key) != map.end(); }
+    const K& nextKey(const K& key) { return key; }
+    std::vector<K> allKeysInOrder() { return {}; }
+    template <typename F>
+    void forEach(F&& fn) {
+        for (const auto& [key, value] : map) {
+            fn(key, value);
+        }
+    }
+    void erase(const K& key) { map.erase(key); }
+};
+
+template <typename K, typename V>
+void recordSearchCost(const std::vector<K>& keys, size_t lookups, const std::string& keyType,
+                      const std::string& valueType) {
+    proj2::SkipList<K, V, proj2::CountingSkipListTraits> list;
+    const V value{makeValue<V>(1)};
+    for (const K& key : keys) {
+        list.insert(key, value);
+    }
+    list.resetStats();
+    for (size_t i = 0; i < lookups; i++) {
+        consume(list.find(keys[i]));
+    }
+
+    const proj2::SkipListStats& stats{list.stats()};
+    const auto calls = static_cast<double>(stats.lookups);
+    SearchCost cost{keyType,
+                    valueType,
+                    keys.size(),
+                    lookups,
+                    static_cast<double>(stats.nextHops + stats.downHops) / calls,
+                    static_cast<double>(stats.comparisons) / calls,
+                    std::log2(static_cast<double>(keys.size()))};
+    searchCosts.push_back(cost);
+    if (verbose) {
+        std::cerr << "SkipList " << keyType << "/" << valueType << " n=" << keys.size()
+                  << " hops/lookup: " << cost.hopsPerLookup
+                  << " (log_2 n = " << cost.expectedHops
+                  << "), comparisons/lookup: " << cost.comparisonsPerLookup << "\n";
+    }
+}
+
+template <template <typename, typename> typename Adapter, typename K, typename V>
+void runWorkload(size_t size, const std::string& keyType,
+                 const std::string& valueType, std::vector<Result>& results) {
+    using Container = Adapter<K, V>;
+
+    std::mt19937_64 random{SEED};
+    std::vector<uint64_t> order(size);
+    for (size_t i = 0; i < size; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), random);
+
+    std::vector<K> keys;
+    keys.reserve(size);
+    for (uint64_t i : order) {
+        keys.push_back(makeKey<K>(i));
+    }
+    const V value{makeValue<V>(1)};
+    const size_t lookups{std::min(size, LOOKUP_SAMPLE)};
+    std::vector<K> misses;
+    misses.reserve(lookups);
+    for (size_t i = 0; i < lookups; i++) {
+        misses.push_back(makeKey<K>(order[i]) + K{});
+    }
+    for (K& miss : misses) {
+        if constexpr (std::is_same_v<K, std::string>) {
+            miss.back() = static_cast<char>(miss.back() + 1);
+        } else {
+            miss++;
+        }
+    }
+
+    auto record = [&](const std::string& operation, size_t ops,
+                      const Measurement& measurement) {
+        const auto perOp = static_cast<double>(ops);
+        Result result{Container::NAME, keyType, valueType, size, operation, ops,
+                      measurement.ns / perOp};
+        for (size_t i = 0; i < measurement.counters.size(); i++) {
+            result.countersPerOp.emplace_back(perf->names()[i],
+                                              measurement.counters[i] / perOp);
+        }
+        if (verbose) {
+            std::cerr << Container::NAME << " " << keyType << "/" << valueType
+                      << " n=" << size << " " << operation << ": " << result.nsPerOp
+                      << " ns/op";
+            for (const auto& [name, count] : result.countersPerOp) {
+                std::cerr << ", " << name << " " << count;
+            }
+            std::cerr << "\n";
+        }
+        results.push_back(result);
+    };
+
+    const int64_t bytesBefore{liveBytes.load()};
+    auto container = std::make_unique<Container>();
+    record("insert", size, measure([&]() {
+               for (const K& key : keys) {
+                   container->insert(key, value);
+               }
+               container->finishInserts();
+           }));
+    results.back().bytesPerKey =
+        static_cast<double>(liveBytes.load() - bytesBefore) / static_cast<double>(size);
+
+    record("find_hit", lookups, measure([&]() {
+               for (size_t i = 0; i < lookups; i++) {
+                   consume(container->findHit(keys[i]));
+               }
+           }));
+
+    record("find_miss", lookups, measure([&]() {
+               for (size_t i = 0; i < lookups; i++) {
+                   consume(container->findMiss(misses[i]));
+               }
+           }));
+
+    if constexpr (Container::ORDERED) {
+        // The largest key has no successor, so it is left out
+        const size_t nextLookups{std::min(lookups, size - 1)};
+        const K& largest{*std::max_element(keys.begin(), keys.end())};
+        std::vector<K> withSuccessor;
+        withSuccessor.reserve(nextLookups);
+        for (size_t i = 0; withSuccessor.size() < nextLookups; i++) {
+            if (keys[i] != largest) {
+                withSuccessor.push_back(keys[i]);
+            }
+        }
+        if (nextLookups > 0) {
+            record("next_key", nextLookups, measure([&]() {
+                       for (const K& key : withSuccessor) {
+                           consume(container->nextKey(key));
+                       }
+                   }));
+        }
+
+        record("all_keys_in_order", size, measure([&]() {
+                   consume(container->allKeysInOrder().size());
+               }));
+    }
+
+    record("iterate", size, measure([&]() {
+               container->forEach([](const K& key, const V&) { consume(key); });
+           }));
+
+    const size_t erases{std::min(size, Container::ERASES)};
+    record("erase", erases, measure([&]() {
+               for (size_t i = 0; i < erases; i++) {
+                   container->erase(keys[i]);
+               }
+           }));
+
+    if constexpr (std::is_same_v<Container, SkipListAdapter<K, V>>) {
+        if (measureSearchCost) {
+            container.reset();
+            recordSearchCost<K, V>(keys, lookups, keyType, valueType);
+        }
+    }
+}
+
+template <typename K, typename V>
+void runContainers(size_t size, const std::vector<std::string>& containers,
+                   const std::string& keyType, const std::string& valueType,
+                   std::vector<Result>& results) {
+    auto wanted = [&](const std::string& name) {
+        return std::find(containers.begin(), containers.end(), name) != containers.end();
+    };
+    if (wanted("skiplist")) {
+        runWorkload<SkipListAdapter, K, V>(size, keyType, valueType, results);
+    }
+    if constexpr (std::is_same_v<K, std::string>) {
+        if (wanted("plainkeys")) {
+            runWorkload<PlainKeysSkipListAdapter, K, V>(size, keyType, valueType, results);
+        }
+    }
+    if (wanted("compact")) {
+        runWorkload<CompactSkipListAdapter, K, V>(size, keyType, valueType, results);
+    }
+    if (wanted("unrolled")) {
+        runWorkload<UnrolledSkipListAdapter, K, V>(size, keyType, valueType, results);
+    }
+    if constexpr (proj2::SimdSearchableKey<K>) {
+        if (wanted("simd")) {
+            runWorkload<SimdSkipListAdapter, K, V>(size, keyType, valueType, results);
+        }
+    }
+    if (wanted("map")) {
+        runWorkload<MapAdapter, K, V>(size, keyType, valueType, results);
+    }
+    if (wanted("vector")) {
+        runWorkload<SortedVectorAdapter, K, V>(size, keyType, valueType, results);
+    }
+    if (wanted("unordered_map")) {
+        runWorkload<UnorderedMapAdapter, K, V>(size, keyType, valueType, results);
+    }
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream{list};
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (not item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::string jsonString(const std::string& text) {
+    std::string quoted{"\""};
+    for (char character : text) {
+        if (character == '"' or character == '\\') {
+            quoted += '\\';
+        }
+        quoted += character;
+    }
+    return quoted + "\"";
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    out << "{\n  \"benchmark\": \"46ProjectBench\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result{results[i]};
+        out << "    {\"container\": " << jsonString(result.container)
+            << ", \"key\": " << jsonString(result.keyType)
+            << ", \"value\": " << jsonString(result.valueType)
+            << ", \"size\": " << result.size
+            << ", \"operation\": " << jsonString(result.operation)
+            << ", \"ops\": " << result.ops << ", \"ns_per_op\": " << result.nsPerOp;
+        if (result.bytesPerKey > 0) {
+            out << ", \"bytes_per_key\": " << result.bytesPerKey;
+        }
+        for (const auto& [name, count] : result.countersPerOp) {
+            out << ", \"" << name << "_per_op\": " << count;
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]";
+    if (not searchCosts.empty()) {
+        out << ",\n  \"search_cost\": [\n";
+        for (size_t i = 0; i < searchCosts.size(); i++) {
+            const SearchCost& cost{searchCosts[i]};
+            out << "    {\"key\": " << jsonString(cost.keyType)
+                << ", \"value\": " << jsonString(cost.valueType)
+                << ", \"size\": " << cost.size << ", \"lookups\": " << cost.lookups
+                << ", \"hops_per_lookup\": " << cost.hopsPerLookup
+                << ", \"comparisons_per_lookup\": " << cost.comparisonsPerLookup
+                << ", \"log2_size\": " << cost.expectedHops << "}"
+                << (i + 1 < searchCosts.size() ? "," : "") << "\n";
+        }
+        out << "  ]";
+    }
+    out << "\n}\n";
+}
+
+std::vector<Result> runAll(const std::vector<size_t>& sizes,
+                           const std::vector<std::string>& containers,
+                           const std::vector<std::string>& types) {
+    std::vector<Result> results;
+    for (size_t size : sizes) {
+        for (const std::string& type : types) {
+            if (type == "unsigned") {
+                runContainers<unsigned, unsigned>(size, containers, "unsigned",
+                                                  "unsigned", results);
+            } else if (type == "string") {
+                runContainers<std::string, std::string>(size, containers, "string",
+                                                        "string", results);
+            } else if (type == "text") {
+                stringKeys = StringKeys::Scattered;
+                runContainers<std::string, std::string>(size, containers, "text",
+                                                        "string", results);
+                stringKeys = StringKeys::SharedPrefix;
+            } else if (type == "large") {
+                runContainers<unsigned, LargeValue>(size, containers, "unsigned",
+                                                    "large[1024]", results);
+            }
+        }
+    }
+    return results;
+}
+
+// The regression workloads, keeping each figure's best of *repeats* runs
+// since noise only ever makes a run slower
+void keepBest(std::vector<Result>& best, const std::vector<Result>& next) {
+    for (size_t i = 0; i < best.size(); i++) {
+        best[i].nsPerOp = std::min(best[i].nsPerOp, next[i].nsPerOp);
+    }
+}
+
+std::vector<Result> runBest(size_t repeats) {
+    std::vector<Result> best{runAll(COMPARE_SIZES, {"skiplist"}, COMPARE_TYPES)};
+    for (size_t run = 1; run < repeats; run++) {
+        keepBest(best, runAll(COMPARE_SIZES, {"skiplist"}, COMPARE_TYPES));
+    }
+    return best;
+}
+
+// Value of "*field*" in a line written by writeJson, or "" if absent
+std::string jsonField(const std::string& line, const std::string& field) {
+    const std::string name{"\"" + field + "\": "};
+    size_t start{line.find(name)};
+    if (start == std::string::npos) {
+        return "";
+    }
+    start += name.size();
+    if (line[start] == '"') {
+        std::string text;
+        for (size_t i = start + 1; i < line.size() and line[i] != '"'; i++) {
+            if (line[i] == '\\') {
+                i++;
+            }
+            text += line[i];
+        }
+        return text;
+    }
+    return line.substr(start, line.find_first_of(",}", start) - start);
+}
+
+// Read results back from a file written by writeJson
+std::vector<Result> readJson(const std::string& path) {
+    std::ifstream in{path};
+    if (not in) {
+        throw std::runtime_error("Cannot open baseline " + path);
+    }
+    std::vector<Result> results;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (jsonField(line, "operation").empty()) {
+            continue;
+        }
+        Result result{jsonField(line, "container"),
+                      jsonField(line, "key"),
+                      jsonField(line, "value"),
+                      std::stoull(jsonField(line, "size")),
+                      jsonField(line, "operation"),
+                      std::stoull(jsonField(line, "ops")),
+                      std::stod(jsonField(line, "ns_per_op"))};
+        std::string bytes{jsonField(line, "bytes_per_key")};
+        if (not bytes.empty()) {
+            result.bytesPerKey = std::stod(bytes);
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+// Print each baseline figure next to the current one and return false if
+// any is missing or more than *threshold* (a fraction) worse
+bool compareToBaseline(const std::vector<Result>& baseline,
+                       const std::vector<Result>& current, Metrics metrics,
+                       double threshold, bool print = true) {
+    std::ostringstream report;
+    bool passed{true};
+    auto check = [&](const Result& expected, const std::string& metric, double before,
+                     double after) {
+        const bool regressed{after > before * (1.0 + threshold)};
+        report << (regressed ? "REGRESSED " : "ok        ") << expected.container
+                  << " " << expected.keyType << "/" << expected.valueType
+                  << " n=" << expected.size << " " << expected.operation << " "
+                  << metric << ": " << before << " -> " << after << "\n";
+        passed = passed and not regressed;
+    };
+
+    for (const Result& expected : baseline) {
+        auto found = std::find_if(current.begin(), current.end(), [&](const Result& r) {
+            return r.container == expected.container and r.keyType == expected.keyType and
+                   r.valueType == expected.valueType and r.size == expected.size and
+                   r.operation == expected.operation;
+        });
+        if (found == current.end()) {
+            report << "MISSING   " << expected.container << " " << expected.keyType
+                      << "/" << expected.valueType << " n=" << expected.size << " "
+                      << expected.operation << "\n";
+            passed = false;
+            continue;
+        }
+        if (metrics != Metrics::Memory) {
+            check(expected, "ns/op", expected.nsPerOp, found->nsPerOp);
+        }
+        if (metrics != Metrics::Time and expected.bytesPerKey > 0) {
+            check(expected, "bytes/key", expected.bytesPerKey, found->bytesPerKey);
+        }
+    }
+    report << (passed ? "No regressions" : "Regressions found") << " (threshold "
+           << threshold * 100.0 << "%)\n";
+    if (print) {
+        std::cout << report.str();
+    }
+    return passed;
+}
+
+bool isWithinThreshold(const std::vector<Result>& baseline,
+                       const std::vector<Result>& current, Metrics metrics,
+                       double threshold) {
+    return compareToBaseline(baseline, current, metrics, threshold, false);
+}
+
+void help() {
+    std::cout
+        << "Usage: 46ProjectBench [options]\n"
+           "\n"
+           "Options:\n"
+           "  --sizes=<n,...>        Key counts to run (default 1000,10000,100000,1000000;\n"
+           "                         up to 100000000 if you have the memory)\n"
+           "  --containers=<c,...>   Any of skiplist,plainkeys,compact,unrolled,simd,\n"
+           "                         map,vector,unordered_map (simd only runs integer\n"
+           "                         keys, plainkeys only string keys) (default all)\n"
+           "  --types=<t,...>        Any of unsigned,string,text,large (default all);\n"
+           "                         string keys share a long prefix, text keys do not\n"
+           "  --out=<path>           Write the JSON results to path instead of stdout\n"
+           "  --compare=<path>       Run the SkipList regression workloads and fail if\n"
+           "                         any result is worse than the baseline at path\n"
+           "  --metrics=<m>          What --compare checks: memory (bytes/key, the\n"
+           "                         default), time (ns/op, only against a baseline\n"
+           "                         from this machine) or all\n"
+           "  --threshold=<percent>  How much worse counts as a regression (default 25)\n"
+           "  --no-perf              Do not read hardware performance counters\n"
+           "  --write-baseline=<path> Record the regression workloads as a new baseline\n"
+           "  --help                 Displays this message\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes{1000, 10000, 100000, 1000000};
+    std::vector<std::string> containers{"skiplist", "plainkeys", "compact",      "unrolled",
+                                        "simd",     "map",       "vector", "unordered_map"};
+    std::vector<std::string> types{"unsigned", "string", "text", "large"};
+    std::string outPath;
+    std::string comparePath;
+    std::string baselinePath;
+    double threshold{DEFAULT_THRESHOLD_PERCENT};
+    Metrics metrics{Metrics::Memory};
+    bool usePerf{true};
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg{argv[i]};
+        std::string value{arg.substr(arg.find('=') + 1)};
+        if (arg.starts_with("--sizes=")) {
+            sizes.clear();
+            for (const std::string& size : splitList(value)) {
+                sizes.push_back(std::stoull(size));
+            }
+        } else if (arg.starts_with("--containers=")) {
+            containers = splitList(value);
+        } else if (arg.starts_with("--types=")) {
+            types = splitList(value);
+        } else if (arg.starts_with("--out=")) {
+            outPath = value;
+        } else if (arg.starts_with("--compare=")) {
+            comparePath = value;
+        } else if (arg.starts_with("--write-baseline=")) {
+            baselinePath = value;
+        } else if (arg == "--no-perf") {
+            usePerf = false;
+        } else if (arg.starts_with("--metrics=")) {
+            if (value == "memory") {
+                metrics = Metrics::Memory;
+            } else if (value == "time") {
+                metrics = Metrics::Time;
+            } else if (value == "all") {
+                metrics = Metrics::All;
+            } else {
+                std::cerr << "Unexpected metrics " << value << "\n";
+                help();
+                return 1;
+            }
+        } else if (arg.starts_with("--threshold=")) {
+            threshold = std::stod(value);
+        } else if (arg == "--help" or arg == "-h") {
+            help();
+            return 0;
+        } else {
+            std::cerr << "Unexpected argument " << arg << "\n";
+            help();
+            return 1;
+        }
+    }
+
+    if (not comparePath.empty() or not baselinePath.empty()) {
+        verbose = false;
+        measureSearchCost = false;
+        // Bytes/key come out the same every run
+        const bool timed{not baselinePath.empty() or metrics != Metrics::Memory};
+        std::vector<Result> results{runBest(timed ? COMPARE_REPEATS : 1)};
+        if (not baselinePath.empty()) {
+            std::ofstream out{baselinePath};
+            writeJson(out, results);
+            return 0;
+        }
+        // A timing regression has to survive COMPARE_ROUNDS rounds, each
+        // folded into the best-so-far figures, before it fails the gate
+        const std::vector<Result> baseline{readJson(comparePath)};
+        for (size_t round = 1; timed and round < COMPARE_ROUNDS; round++) {
+            if (isWithinThreshold(baseline, results, metrics, threshold / 100.0)) {
+                break;
+            }
+            keepBest(results, runBest(COMPARE_REPEATS));
+        }
+        return compareToBaseline(baseline, results, metrics, threshold / 100.0) ? 0 : 1;
+    }
+
+    if (usePerf) {
+        perf = std::make_unique<PerfCounters>();
+        if (not perf->available()) {
+            std::cerr << "Hardware counters are unavailable (not Linux, or "
+                         "perf_event_open is not permitted); reporting times only\n";
+            perf.reset();
+        }
+    }
+    std::cerr << "UnrolledSkipList integer key search: " << proj2::KEY_SEARCH_INSTRUCTION_SET
+              << "\n";
+    std::vector<Result> results{runAll(sizes, containers, types)};
+    if (outPath.empty()) {
+        writeJson(std::cout, results);
+    } else {
+        std::ofstream out{outPath};
+        writeJson(out, results);
+    }
+    return 0;
+}
@@ -0,0 +1,288 @@
+#ifndef ___BINARY_IO_HPP
+#define ___BINARY_IO_HPP
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief 64-bit FNV-1a hash, used to checksum the files the skip list
+ * writes. It is not cryptographic; it only has to catch torn writes and
+ * flipped bits.
+ */
+class Fnv1a {
+   public:
+    void update(const void* data, size_t length) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ bytes[i]) * PRIME;
+        }
+    }
+
+    [[nodiscard]] uint64_t digest() const noexcept { return hash; }
+
+   private:
+    static constexpr uint64_t OFFSET_BASIS{14695981039346656037ULL};
+    static constexpr uint64_t PRIME{1099511628211ULL};
+    uint64_t hash{OFFSET_BASIS};
+};
+
+/**
+ * @brief Buffered binary output file that checksums everything written to
+ * it. Values are written in the machine's native byte order, so files are
+ * meant to be read back on the same architecture.
+ */
+class BinaryWriter {
+   public:
+    // Throw a std::runtime_error if *path* cannot be opened for writing.
+    explicit BinaryWriter(const std::string& path)
+        : out{path, std::ios::binary | std::ios::trunc}, path{path} {
+        if (not out) {
+            throw std::runtime_error("Cannot open " + path + " for writing");
+        }
+    }
+
+    void write(const void* data, size_t length) {
+        checksum.update(data, length);
+        out.write(static_cast<const char*>(data),
+                  static_cast<std::streamsize>(length));
+        bytesWritten += length;
+    }
+
+    template <typename T>
+    void writeValue(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(&value, sizeof(T));
+    }
+
+    // Offset the next write will land at.
+    [[nodiscard]] size_t position() const noexcept { return bytesWritten; }
+
+    // Append the checksum of everything written so far and flush the file.
+    // Throw a std::runtime_error if any write failed.
+    void finish() {
+        uint64_t digest{checksum.digest()};
+        out.write(reinterpret_cast<const char*>(&digest), sizeof(digest));
+        out.flush();
+        if (not out) {
+            throw std::runtime_error("Failed writing " + path);
+        }
+    }
+
+   private:
+    std::ofstream out;
+    std::string path;
+    Fnv1a checksum;
+    size_t bytesWritten{0};
+};
+
+/**
+ * @brief Binary input file matching BinaryWriter. Every read checks that
+ * the file really holds that many bytes, so a truncated or corrupt file
+ * surfaces as a std::runtime_error instead of garbage.
+ */
+class BinaryReader {
+   public:
+    // Throw a std::runtime_error if *path* cannot be opened for reading.
+    explicit BinaryReader(const std::string& path)
+        : in{path, std::ios::binary | std::ios::ate}, path{path} {
+        if (not in) {
+            throw std::runtime_error("Cannot open " + path + " for reading");
+        }
+        remainingBytes = static_cast<size_t>(in.tellg());
+        in.seekg(0);
+    }
+
+    void read(void* data, size_t length) {
+        if (length > remainingBytes) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        in.read(static_cast<char*>(data), static_cast<std::streamsize>(length));
+        if (not in) {
+            throw std::runtime_error("Failed reading " + path);
+        }
+        remainingBytes -= length;
+        checksum.update(data, length);
+    }
+
+    template <typename T>
+    [[nodiscard]] T readValue() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        read(&value, sizeof(T));
+        return value;
+    }
+
+    // Bytes left in the file, used to reject impossible lengths before
+    // allocating for them.
+    [[nodiscard]] size_t remaining() const noexcept { return remainingBytes; }
+
+    // Read the checksum written by BinaryWriter::finish and compare it with
+    // everything read so far. Throw a std::runtime_error if they differ or
+    // if the file continues past the checksum.
+    void verifyChecksum() {
+        uint64_t expected{checksum.digest()};
+        if (remainingBytes != sizeof(uint64_t)) {
+            throw std::runtime_error(path + " has the wrong length");
+        }
+        uint64_t stored{readValue<uint64_t>()};
+        if (stored != expected) {
+            throw std::runtime_error(path + " failed its checksum");
+        }
+    }
+
+   private:
+    std::ifstream in;
+    std::string path;
+    size_t remainingBytes{0};
+    Fnv1a checksum;
+};
+
+/**
+ * @brief Appends binary data to an in-memory buffer, for records that are
+ * built up before they are written out in one piece.
+ */
+class BufferWriter {
+   public:
+    explicit BufferWriter(std::string& buffer) : buffer{buffer} {}
+
+    void write(const void* data, size_t length) {
+        buffer.append(static_cast<const char*>(data), length);
+    }
+
+    template <typename T>
+    void writeValue(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(&value, sizeof(T));
+    }
+
+   private:
+    std::string& buffer;
+};
+
+/**
+ * @brief Reads binary data back out of a buffer filled by BufferWriter.
+ * Reading past the end throws a std::runtime_error.
+ */
+class BufferReader {
+   public:
+    BufferReader(const char* data, size_t length)
+        : data{data}, remainingBytes{length} {}
+
+    void read(void* destination, size_t length) {
+        if (length > remainingBytes) {
+            throw std::runtime_error("Record is truncated");
+        }
+        std::memcpy(destination, data, length);
+        data += length;
+        remainingBytes -= length;
+    }
+
+    template <typename T>
+    [[nodiscard]] T readValue() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        read(&value, sizeof(T));
+        return value;
+    }
+
+    [[nodiscard]] size_t remaining() const noexcept { return remainingBytes; }
+
+   private:
+    const char* data;
+    size_t remainingBytes;
+};
+
+// Force the contents of the file or directory at *path* to disk. For a
+// directory that means the names created, renamed or removed in it. Throw
+// a std::runtime_error if that fails.
+inline void syncPath(const std::string& path) {
+    int fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + " to sync it");
+    }
+    int result{0};
+    do {
+        result = ::fsync(fd);
+    } while (result != 0 and errno == EINTR);
+    ::close(fd);
+    if (result != 0) {
+        throw std::runtime_error("Failed syncing " + path);
+    }
+}
+
+/**
+ * @brief Replace *to* with the finished file *from*, so that after a power
+ * loss *to* holds either its old contents or all of *from*'s.
+ *
+ * *from* is synced before the rename, since otherwise the rename could
+ * reach the disk ahead of the data, and the directory is synced after it,
+ * so the new name is on disk before anything that relies on it happens.
+ */
+inline void durableRename(const std::string& from, const std::string& to) {
+    syncPath(from);
+    std::filesystem::rename(from, to);
+    std::filesystem::path directory{std::filesystem::path{to}.parent_path()};
+    syncPath(directory.empty() ? std::string{"."} : directory.string());
+}
+
+/**
+ * @brief How keys and values are laid out in binary files and records.
+ *
+ * Trivially copyable types are copied as raw bytes, a whole array per call.
+ * std::string is written as a 64-bit length followed by its characters.
+ * Other types can be supported by specializing this template. Writers and
+ * readers are BinaryWriter / BinaryReader or BufferWriter / BufferReader.
+ */
+template <typename T>
+struct BinaryCodec {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "No BinaryCodec specialization for this type");
+
+    template <typename Writer>
+    static void write(Writer& writer, const T* items, size_t count) {
+        writer.write(items, sizeof(T) * count);
+    }
+
+    template <typename Reader>
+    static void read(Reader& reader, T* items, size_t count) {
+        reader.read(items, sizeof(T) * count);
+    }
+};
+
+template <>
+struct BinaryCodec<std::string> {
+    template <typename Writer>
+    static void write(Writer& writer, const std::string* items, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            writer.writeValue(static_cast<uint64_t>(items[i].size()));
+            writer.write(items[i].data(), items[i].size());
+        }
+    }
+
+    template <typename Reader>
+    static void read(Reader& reader, std::string* items, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            auto length = reader.template readValue<uint64_t>();
+            if (length > reader.remaining()) {
+                throw std::runtime_error("String length runs past the end");
+            }
+            items[i].resize(length);
+            reader.read(items[i].data(), length);
+        }
+    }
+};
+
+}  // namespace shindler::ics46::project2
+#endif
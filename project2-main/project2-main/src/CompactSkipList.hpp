@@ -0,0 +1,358 @@
+#ifndef ___COMPACT_SKIP_LIST_HPP
+#define ___COMPACT_SKIP_LIST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "SkipList.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief SkipList laid out in one pool of nodes, linked by 32-bit indices
+ * into the pool instead of 64-bit pointers.
+ *
+ * Every node still has next, up, down and previous links and the list
+ * still has two sentinels per layer. Keys are promoted by the same coin
+ * and layer cap as SkipList, so both build the same towers for the same
+ * keys. The links take 16 bytes per node rather than 32, and nodes are
+ * allocated CHUNK_NODES at a time, next to each other, rather than one by
+ * one with a malloc header each.
+ *
+ * Chunks are never moved, so iterators and references to values stay
+ * valid until their key is erased. Erased nodes go on a free list and are
+ * reused by later inserts; the pool only grows. It holds at most 2^32 - 1
+ * nodes, sentinels included; an insert that needs more throws a
+ * std::length_error.
+ *
+ * K and V must be default constructible, like SkipList's.
+ */
+template <typename K, typename V>
+class CompactSkipList {
+   public:
+    using Index = uint32_t;
+
+   private:
+    static constexpr Index NONE{std::numeric_limits<Index>::max()};
+
+    struct Node {
+        K key{};
+        V value{};
+        Index next{NONE};
+        Index up{NONE};
+        Index down{NONE};
+        Index previous{NONE};
+    };
+
+    // Node i is entry i % CHUNK_NODES of chunk i / CHUNK_NODES
+    static constexpr size_t CHUNK_BITS{10};
+    static constexpr size_t CHUNK_NODES{size_t{1} << CHUNK_BITS};
+    std::vector<std::unique_ptr<Node[]>> chunks;
+    size_t poolNodes{0};
+    // Erased nodes, linked through next
+    Index freeList{NONE};
+    Index front;
+    Index back;
+    Index topFront;
+    Index topBack;
+    size_t entries{0};
+    size_t layerCount{2};
+
+    [[nodiscard]] Node& at(Index node) {
+        return chunks[node >> CHUNK_BITS][node & (CHUNK_NODES - 1)];
+    }
+    [[nodiscard]] const Node& at(Index node) const {
+        return chunks[node >> CHUNK_BITS][node & (CHUNK_NODES - 1)];
+    }
+    Index allocate(const K& key, const V& value);
+    void release(Index node);
+    void addTopLayer();
+    [[nodiscard]] bool isBack(Index node) const { return at(node).next == NONE; }
+    [[nodiscard]] Index predecessor(const K& key) const;
+    [[nodiscard]] Index findIndex(const K& key) const;
+
+   public:
+    // Forward iterator over the keys in increasing order; dereferences to
+    // a pair of references like SkipList::const_iterator.
+    class const_iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = std::pair<const K&, const V&>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return {list->at(node).key, list->at(node).value};
+        }
+
+        const_iterator& operator++() {
+            node = list->at(node).next;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous{*this};
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const = default;
+
+       private:
+        friend class CompactSkipList;
+        const_iterator(const CompactSkipList* list, Index node) : list{list}, node{node} {}
+        const CompactSkipList* list{nullptr};
+        Index node{NONE};
+    };
+
+    CompactSkipList();
+
+    CompactSkipList(const CompactSkipList&) = delete;
+    CompactSkipList(CompactSkipList&&) = delete;
+    CompactSkipList& operator=(const CompactSkipList&) = delete;
+    CompactSkipList& operator=(CompactSkipList&&) = delete;
+
+    [[nodiscard]] size_t size() const noexcept { return entries; }
+    [[nodiscard]] bool empty() const noexcept { return entries == 0; }
+    [[nodiscard]] size_t layers() const noexcept { return layerCount; }
+
+    // Nodes in the pool, sentinels and free nodes included, and the number
+    // of those that are free
+    [[nodiscard]] size_t poolSize() const noexcept { return poolNodes; }
+    [[nodiscard]] size_t freeNodes() const noexcept;
+
+    // Same contracts as the SkipList members of the same names.
+    [[nodiscard]] size_t height(const K& key) const;
+    bool insert(const K& key, const V& value);
+    [[nodiscard]] V& find(const K& key);
+    [[nodiscard]] const V& find(const K& key) const;
+    [[nodiscard]] bool contains(const K& key) const;
+    [[nodiscard]] const K& nextKey(const K& key) const;
+    [[nodiscard]] const K& previousKey(const K& key) const;
+    [[nodiscard]] std::vector<K> allKeysInOrder() const;
+    void erase(const K& key);
+
+    [[nodiscard]] const_iterator begin() const { return {this, at(front).next}; }
+    [[nodiscard]] const_iterator end() const { return {this, back}; }
+    [[nodiscard]] const_iterator lower_bound(const K& key) const {
+        return {this, at(predecessor(key)).next};
+    }
+};
+
+template <typename K, typename V>
+CompactSkipList<K, V>::CompactSkipList() {
+    front = allocate({}, {});
+    back = allocate({}, {});
+    topFront = allocate({}, {});
+    topBack = allocate({}, {});
+    at(front).next = back;
+    at(front).up = topFront;
+    at(back).previous = front;
+    at(back).up = topBack;
+    at(topFront).next = topBack;
+    at(topFront).down = front;
+    at(topBack).previous = topFront;
+    at(topBack).down = back;
+}
+
+template <typename K, typename V>
+typename CompactSkipList<K, V>::Index CompactSkipList<K, V>::allocate(const K& key,
+                                                                      const V& value) {
+    if (freeList != NONE) {
+        Index node{freeList};
+        freeList = at(node).next;
+        at(node) = Node{key, value};
+        return node;
+    }
+    if (poolNodes == NONE) {
+        throw std::length_error("CompactSkipList is out of 32-bit node indices");
+    }
+    if (poolNodes == chunks.size() * CHUNK_NODES) {
+        chunks.push_back(std::make_unique<Node[]>(CHUNK_NODES));
+    }
+    auto node = static_cast<Index>(poolNodes++);
+    at(node) = Node{key, value};
+    return node;
+}
+
+template <typename K, typename V>
+void CompactSkipList<K, V>::release(Index node) {
+    // Drop whatever the key and value own before the node waits for reuse
+    at(node) = Node{};
+    at(node).next = freeList;
+    freeList = node;
+}
+
+template <typename K, typename V>
+size_t CompactSkipList<K, V>::freeNodes() const noexcept {
+    size_t free{0};
+    for (Index node = freeList; node != NONE; node = at(node).next) {
+        free++;
+    }
+    return free;
+}
+
+template <typename K, typename V>
+void CompactSkipList<K, V>::addTopLayer() {
+    Index newTop{allocate({}, {})};
+    Index newTopBack{allocate({}, {})};
+    at(newTop).down = topFront;
+    at(newTop).next = newTopBack;
+    at(newTopBack).down = topBack;
+    at(newTopBack).previous = newTop;
+    at(topFront).up = newTop;
+    at(topBack).up = newTopBack;
+    topFront = newTop;
+    topBack = newTopBack;
+    layerCount++;
+}
+
+template <typename K, typename V>
+typename CompactSkipList<K, V>::Index CompactSkipList<K, V>::predecessor(
+    const K& key) const {
+    // The last base layer node whose key is less than *key*, which is the
+    // front sentinel if there is none
+    Index node{topFront};
+    while (true) {
+        Index next{at(node).next};
+        while (not isBack(next) and at(next).key < key) {
+            node = next;
+            next = at(node).next;
+        }
+        if (at(node).down == NONE) {
+            return node;
+        }
+        node = at(node).down;
+    }
+}
+
+template <typename K, typename V>
+typename CompactSkipList<K, V>::Index CompactSkipList<K, V>::findIndex(const K& key) const {
+    Index node{at(predecessor(key)).next};
+    if (isBack(node) or not(at(node).key == key)) {
+        throw std::out_of_range("Key is not in the CompactSkipList");
+    }
+    return node;
+}
+
+template <typename K, typename V>
+size_t CompactSkipList<K, V>::height(const K& key) const {
+    size_t tower{0};
+    for (Index node = findIndex(key); node != NONE; node = at(node).up) {
+        tower++;
+    }
+    return tower;
+}
+
+template <typename K, typename V>
+bool CompactSkipList<K, V>::insert(const K& key, const V& value) {
+    Index previous{predecessor(key)};
+    if (not isBack(at(previous).next) and at(at(previous).next).key == key) {
+        return false;
+    }
+
+    Index below{allocate(key, value)};
+    at(below).previous = previous;
+    at(below).next = at(previous).next;
+    at(at(previous).next).previous = below;
+    at(previous).next = below;
+    entries++;
+
+    // Promote as SkipList::insert does
+    size_t numberOfFlips{0};
+    size_t layers{1};
+    while (flipCoin(key, numberOfFlips)) {
+        if (layers == layerCount - 1) {
+            addTopLayer();
+        }
+        while (at(previous).up == NONE) {
+            previous = at(previous).previous;
+        }
+        previous = at(previous).up;
+
+        Index node{allocate(key, value)};
+        at(node).previous = previous;
+        at(node).down = below;
+        at(node).next = at(previous).next;
+        at(below).up = node;
+        at(at(previous).next).previous = node;
+        at(previous).next = node;
+        below = node;
+
+        if (reachedLayerCap(entries, layerCount)) {
+            break;
+        }
+        layers++;
+        numberOfFlips++;
+    }
+    return true;
+}
+
+template <typename K, typename V>
+V& CompactSkipList<K, V>::find(const K& key) {
+    return at(findIndex(key)).value;
+}
+
+template <typename K, typename V>
+const V& CompactSkipList<K, V>::find(const K& key) const {
+    return at(findIndex(key)).value;
+}
+
+template <typename K, typename V>
+bool CompactSkipList<K, V>::contains(const K& key) const {
+    Index node{at(predecessor(key)).next};
+    return not isBack(node) and at(node).key == key;
+}
+
+template <typename K, typename V>
+const K& CompactSkipList<K, V>::nextKey(const K& key) const {
+    Index next{at(findIndex(key)).next};
+    if (isBack(next)) {
+        throw std::out_of_range("Key is the largest in the CompactSkipList");
+    }
+    return at(next).key;
+}
+
+template <typename K, typename V>
+const K& CompactSkipList<K, V>::previousKey(const K& key) const {
+    Index previous{at(findIndex(key)).previous};
+    if (previous == front) {
+        throw std::out_of_range("Key is the smallest in the CompactSkipList");
+    }
+    return at(previous).key;
+}
+
+template <typename K, typename V>
+std::vector<K> CompactSkipList<K, V>::allKeysInOrder() const {
+    std::vector<K> keys;
+    keys.reserve(entries);
+    for (Index node = at(front).next; not isBack(node); node = at(node).next) {
+        keys.push_back(at(node).key);
+    }
+    return keys;
+}
+
+template <typename K, typename V>
+void CompactSkipList<K, V>::erase(const K& key) {
+    Index node{findIndex(key)};
+    while (node != NONE) {
+        at(at(node).previous).next = at(node).next;
+        at(at(node).next).previous = at(node).previous;
+        Index up{at(node).up};
+        release(node);
+        node = up;
+    }
+    entries--;
+}
+
+}  // namespace shindler::ics46::project2
+#endif
@@ -0,0 +1,263 @@
+#ifndef ___DURABLE_SKIP_LIST_HPP
+#define ___DURABLE_SKIP_LIST_HPP
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "BinaryIO.hpp"
+#include "SkipList.hpp"
+#include "WriteAheadLog.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief A SkipList whose inserts and erases are logged to a write-ahead
+ * log, so its contents survive a crash.
+ *
+ * Opening one loads the last checkpoint (a SkipList snapshot stored next to
+ * the log as `<logPath>.snapshot`), if there is one, and replays the log on
+ * top of it. checkpoint() writes a fresh snapshot and empties the log so
+ * recovery stays short.
+ *
+ * insert and erase may be called from several threads at once. Each change
+ * is applied and appended to the log under a lock, and the wait for the
+ * disk happens after the lock is released, so concurrent writers share
+ * fsyncs through the log's group commit. Reads through skipList() must not
+ * overlap with writes. Values changed in place through find are not
+ * logged.
+ *
+ * Until its record is durable each change keeps what it takes to undo it.
+ * If the log fails, every change whose record it lost is undone, newest
+ * first, before the failing call throws, so the list holds what recovery
+ * would give.
+ */
+template <typename K, typename V>
+class DurableSkipList {
+   public:
+    // Recover the list stored at *logPath* (empty if there is none yet)
+    // and start logging to it. Throw a std::runtime_error if the checkpoint
+    // is corrupt or the log cannot be opened.
+    explicit DurableSkipList(const std::string& logPath, WalOptions options = {});
+
+    DurableSkipList(const DurableSkipList&) = delete;
+    DurableSkipList(DurableSkipList&&) = delete;
+    DurableSkipList& operator=(const DurableSkipList&) = delete;
+    DurableSkipList& operator=(DurableSkipList&&) = delete;
+
+    // Same contract as SkipList::insert. Returns once the insert is as
+    // durable as the WalOptions ask for, and throws a std::runtime_error,
+    // with the insert undone, if the log fails first.
+    bool insert(const K& key, const V& value);
+
+    // Same contract as SkipList::erase. Returns once the erase is as
+    // durable as the WalOptions ask for, and throws a std::runtime_error,
+    // with the erase undone, if the log fails first.
+    void erase(const K& key);
+
+    // Make every change so far durable, whatever the WalOptions say. Throw
+    // a std::runtime_error, with the lost changes undone, if the log fails.
+    void sync();
+
+    // Snapshot the list and empty the log.
+    void checkpoint();
+
+    [[nodiscard]] const SkipList<K, V>& skipList() const noexcept { return list; }
+
+    // Number of log records replayed when this list was opened.
+    [[nodiscard]] size_t recoveredRecords() const noexcept { return replayed; }
+
+   private:
+    enum class Operation : uint8_t { Insert = 1, Erase = 2 };
+
+    // A change whose log record may not be durable yet: an insert of
+    // *key*, or an erase if *erased* holds the tower it took out
+    struct Change {
+        uint64_t sequence{0};
+        K key;
+        typename SkipList<K, V>::node_type erased;
+    };
+
+    std::string snapshotPath;
+    SkipList<K, V> list;
+    size_t replayed{0};
+    WriteAheadLog log;
+    std::mutex lock;
+    // Oldest first
+    std::deque<Change> changes;
+
+    static size_t recover(SkipList<K, V>& list, const std::string& logPath,
+                          const std::string& snapshotPath);
+
+    // Append *record* for the newest change and return its sequence
+    // number, undoing the change if that fails. Called with the lock held.
+    uint64_t logChange(const std::string& record);
+
+    // Call with the lock held
+    void undo(Change& change);
+    void forgetDurableChanges();
+
+    // Call *wait* and, if it throws, undo every change the log lost
+    // before rethrowing.
+    template <typename Wait>
+    void waitOrRollBack(Wait&& wait);
+};
+
+template <typename K, typename V>
+DurableSkipList<K, V>::DurableSkipList(const std::string& logPath, WalOptions options)
+    : snapshotPath{logPath + ".snapshot"},
+      replayed{recover(list, logPath, snapshotPath)},
+      log{logPath, options} {}
+
+template <typename K, typename V>
+size_t DurableSkipList<K, V>::recover(SkipList<K, V>& list, const std::string& logPath,
+                                      const std::string& snapshotPath) {
+    if (std::filesystem::exists(snapshotPath)) {
+        list.load(snapshotPath);
+    }
+
+    return WriteAheadLog::replay(logPath, [&](BufferReader& reader) {
+        auto operation = reader.readValue<Operation>();
+        K key{};
+        BinaryCodec<K>::read(reader, &key, 1);
+        if (operation == Operation::Insert) {
+            V value{};
+            BinaryCodec<V>::read(reader, &value, 1);
+            list.insert(key, value);
+        } else if (operation == Operation::Erase) {
+            if (list.contains(key)) {
+                list.erase(key);
+            }
+        } else {
+            throw std::runtime_error("Unknown operation in " + logPath);
+        }
+    });
+}
+
+template <typename K, typename V>
+bool DurableSkipList<K, V>::insert(const K& key, const V& value) {
+    uint64_t sequence{0};
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        forgetDurableChanges();
+        changes.push_back(Change{0, key, {}});
+        try {
+            if (not list.insert(key, value)) {
+                changes.pop_back();
+                return false;
+            }
+        } catch (...) {
+            changes.pop_back();
+            throw;
+        }
+
+        std::string record;
+        BufferWriter writer{record};
+        writer.writeValue(Operation::Insert);
+        BinaryCodec<K>::write(writer, &key, 1);
+        BinaryCodec<V>::write(writer, &value, 1);
+        sequence = logChange(record);
+    }
+    waitOrRollBack([&]() { log.commit(sequence); });
+    return true;
+}
+
+template <typename K, typename V>
+void DurableSkipList<K, V>::erase(const K& key) {
+    uint64_t sequence{0};
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        forgetDurableChanges();
+        changes.push_back(Change{0, key, {}});
+        try {
+            changes.back().erased = list.extract(key);
+        } catch (...) {
+            changes.pop_back();
+            throw;
+        }
+        if (changes.back().erased.empty()) {
+            changes.pop_back();
+            throw std::out_of_range("Key is not in the DurableSkipList");
+        }
+
+        std::string record;
+        BufferWriter writer{record};
+        writer.writeValue(Operation::Erase);
+        BinaryCodec<K>::write(writer, &key, 1);
+        sequence = logChange(record);
+    }
+    waitOrRollBack([&]() { log.commit(sequence); });
+}
+
+template <typename K, typename V>
+void DurableSkipList<K, V>::sync() {
+    waitOrRollBack([&]() { log.sync(); });
+}
+
+template <typename K, typename V>
+uint64_t DurableSkipList<K, V>::logChange(const std::string& record) {
+    try {
+        changes.back().sequence = log.append(record.data(), record.size());
+    } catch (...) {
+        undo(changes.back());
+        changes.pop_back();
+        throw;
+    }
+    return changes.back().sequence;
+}
+
+template <typename K, typename V>
+void DurableSkipList<K, V>::undo(Change& change) {
+    if (change.erased.empty()) {
+        list.erase(change.key);
+    } else {
+        list.insert(std::move(change.erased));
+    }
+}
+
+template <typename K, typename V>
+void DurableSkipList<K, V>::forgetDurableChanges() {
+    const uint64_t durable{log.durableThrough()};
+    while (not changes.empty() and changes.front().sequence <= durable) {
+        changes.pop_front();
+    }
+}
+
+template <typename K, typename V>
+template <typename Wait>
+void DurableSkipList<K, V>::waitOrRollBack(Wait&& wait) {
+    try {
+        wait();
+    } catch (...) {
+        std::lock_guard<std::mutex> guard{lock};
+        // A failed log never makes anything past durableThrough durable
+        const uint64_t durable{log.durableThrough()};
+        while (not changes.empty() and changes.back().sequence > durable) {
+            undo(changes.back());
+            changes.pop_back();
+        }
+        throw;
+    }
+}
+
+template <typename K, typename V>
+void DurableSkipList<K, V>::checkpoint() {
+    std::lock_guard<std::mutex> guard{lock};
+
+    // The new snapshot only replaces the old one once it is complete and on
+    // disk, and the log is only emptied after the rename is on disk too, so
+    // a crash or power loss at any point leaves a snapshot and log that
+    // recover to the same list.
+    const std::string partialPath{snapshotPath + ".partial"};
+    list.save(partialPath);
+    durableRename(partialPath, snapshotPath);
+    // The snapshot holds every change so far, so none needs undoing
+    changes.clear();
+    log.reset();
+}
+
+}  // namespace shindler::ics46::project2
+#endif
@@ -0,0 +1,279 @@
+#ifndef ___INTRUSIVE_SKIP_LIST_HPP
+#define ___INTRUSIVE_SKIP_LIST_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief The links an object needs to be in one IntrusiveSkipList: a next
+ * pointer for each layer it may reach.
+ *
+ * A key goes up a layer with probability 1/4 and reaches at most LAYERS
+ * layers, so searches stay logarithmic up to about 4^LAYERS objects; past
+ * that the top layer fills up. The hook takes 8 * LAYERS + 8 bytes in
+ * every object whatever its height, while an object uses 4/3 links on
+ * average: the rest is what a list that allocates nothing pays to reach
+ * far. The default of 14 layers (120 bytes) covers about 268M objects; a
+ * list known to stay small can take a smaller hook, such as 8 layers (72
+ * bytes) for 65K objects.
+ *
+ * An object embeds one hook per list it can be in at the same time.
+ */
+template <typename T, size_t LAYERS = 14>
+struct SkipListHook {
+    static_assert(LAYERS > 0 and LAYERS <= UINT8_MAX);
+    static constexpr size_t MAX_LAYERS{LAYERS};
+
+    // The next object on each layer this one is on
+    std::array<T*, LAYERS> next{};
+    // Layers this object is on; zero while it is in no list
+    uint8_t height{0};
+
+    [[nodiscard]] bool linked() const noexcept { return height != 0; }
+};
+
+/**
+ * @brief A skip list of caller-owned T objects, linked through a
+ * SkipListHook member (Hook, e.g. &T::hook) and ordered by a key member
+ * (Key, e.g. &T::id).
+ *
+ * The list allocates nothing: insert and erase only change links in the
+ * objects' hooks, and objects are never copied. Tower heights come from a
+ * hash of the key, up to the hook's MAX_LAYERS; only forward links are
+ * kept, so erase searches for the object from the top.
+ *
+ * Objects must stay put, and keep their key, while they are linked. The
+ * list does not own them: destroying or clearing it unlinks them all, and
+ * an object must be erased before it is destroyed.
+ */
+template <typename T, auto Hook, auto Key>
+class IntrusiveSkipList {
+    using HookType = std::remove_cvref_t<decltype(std::declval<T&>().*Hook)>;
+    using K = std::remove_cvref_t<decltype(std::declval<T&>().*Key)>;
+    static constexpr size_t MAX_LAYERS{HookType::MAX_LAYERS};
+    using Links = std::array<T*, MAX_LAYERS>;
+
+    // The links to the first object on each layer
+    Links heads{};
+    size_t entries{0};
+    // Layers with at least one object, or one while empty
+    size_t layerCount{1};
+
+    static HookType& hookOf(T& object) noexcept { return object.*Hook; }
+    static size_t towerHeight(const K& key) noexcept;
+    static const K& keyOf(const T& object) noexcept { return object.*Key; }
+
+    // The links leading to the first object not less than *key* on every
+    // layer, and that object on the base layer (nullptr if there is none)
+    T* searchPath(const K& key, std::array<Links*, MAX_LAYERS>& path) const;
+
+   public:
+    // Forward iterator over the objects in increasing key order.
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using reference = T&;
+        using pointer = T*;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        reference operator*() const { return *object; }
+        pointer operator->() const { return object; }
+
+        iterator& operator++() {
+            object = hookOf(*object).next[0];
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator previous{*this};
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const iterator& other) const = default;
+
+       private:
+        friend class IntrusiveSkipList;
+        explicit iterator(T* object) : object{object} {}
+        T* object{nullptr};
+    };
+
+    IntrusiveSkipList() = default;
+
+    IntrusiveSkipList(const IntrusiveSkipList&) = delete;
+    IntrusiveSkipList(IntrusiveSkipList&&) = delete;
+    IntrusiveSkipList& operator=(const IntrusiveSkipList&) = delete;
+    IntrusiveSkipList& operator=(IntrusiveSkipList&&) = delete;
+
+    ~IntrusiveSkipList() { clear(); }
+
+    [[nodiscard]] size_t size() const noexcept { return entries; }
+    [[nodiscard]] bool empty() const noexcept { return entries == 0; }
+    [[nodiscard]] size_t layers() const noexcept { return layerCount; }
+
+    // Link *object* in. Return false, leaving it unlinked, if an object
+    // with the same key is already in the list. Throw a std::logic_error if
+    // *object* is already in a list through this hook.
+    bool insert(T& object);
+
+    // Unlink *object*. Throw a std::invalid_argument if it is not in this
+    // list.
+    void erase(T& object);
+
+    // Unlink the object with this key and return it, or return nullptr if
+    // there is none.
+    T* erase(const K& key);
+
+    // The object with this key, or nullptr if there is none
+    [[nodiscard]] T* find(const K& key) const;
+    [[nodiscard]] bool contains(const K& key) const { return find(key) != nullptr; }
+
+    // Height of the object with this key. Throw a std::out_of_range if
+    // there is none.
+    [[nodiscard]] size_t height(const K& key) const;
+
+    // Unlink every object, leaving their hooks as if they had never been
+    // inserted.
+    void clear() noexcept;
+
+    [[nodiscard]] iterator begin() const { return iterator{heads[0]}; }
+    [[nodiscard]] iterator end() const { return iterator{}; }
+
+    // Return an iterator to the first object whose key is not less than
+    // *key*, or end() if there is none.
+    [[nodiscard]] iterator lower_bound(const K& key) const {
+        std::array<Links*, MAX_LAYERS> path;
+        return iterator{searchPath(key, path)};
+    }
+};
+
+template <typename T, auto Hook, auto Key>
+size_t IntrusiveSkipList<T, Hook, Key>::towerHeight(const K& key) noexcept {
+    // Not SkipList's coin: its single byte of hash puts one key in 256 on
+    // every layer above the eighth. splitmix64 of std::hash, which is the
+    // identity for integers, and two bits of it per layer.
+    uint64_t hash{static_cast<uint64_t>(std::hash<K>{}(key)) + 0x9e3779b97f4a7c15ULL};
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return std::min(MAX_LAYERS, 1 + static_cast<size_t>(std::countr_zero(hash)) / 2);
+}
+
+template <typename T, auto Hook, auto Key>
+T* IntrusiveSkipList<T, Hook, Key>::searchPath(const K& key,
+                                               std::array<Links*, MAX_LAYERS>& path) const {
+    // The list does not change here; path is only written through by
+    // insert and erase
+    auto* links = const_cast<Links*>(&heads);
+    for (size_t layer = layerCount; layer-- > 0;) {
+        T* next{(*links)[layer]};
+        while (next != nullptr and keyOf(*next) < key) {
+            links = &hookOf(*next).next;
+            next = (*links)[layer];
+        }
+        path[layer] = links;
+    }
+    return (*path[0])[0];
+}
+
+template <typename T, auto Hook, auto Key>
+bool IntrusiveSkipList<T, Hook, Key>::insert(T& object) {
+    HookType& hook{hookOf(object)};
+    if (hook.linked()) {
+        throw std::logic_error("Object is already in an IntrusiveSkipList");
+    }
+    const K& key{keyOf(object)};
+    std::array<Links*, MAX_LAYERS> path;
+    T* found{searchPath(key, path)};
+    if (found != nullptr and keyOf(*found) == key) {
+        return false;
+    }
+
+    const size_t height{towerHeight(key)};
+    for (; layerCount < height; layerCount++) {
+        path[layerCount] = &heads;
+    }
+
+    for (size_t layer = 0; layer < height; layer++) {
+        hook.next[layer] = (*path[layer])[layer];
+        (*path[layer])[layer] = &object;
+    }
+    hook.height = static_cast<uint8_t>(height);
+    entries++;
+    return true;
+}
+
+template <typename T, auto Hook, auto Key>
+void IntrusiveSkipList<T, Hook, Key>::erase(T& object) {
+    std::array<Links*, MAX_LAYERS> path;
+    if (not hookOf(object).linked() or searchPath(keyOf(object), path) != &object) {
+        throw std::invalid_argument("Object is not in this IntrusiveSkipList");
+    }
+
+    HookType& hook{hookOf(object)};
+    for (size_t layer = 0; layer < hook.height; layer++) {
+        (*path[layer])[layer] = hook.next[layer];
+    }
+    hook = HookType{};
+    entries--;
+    while (layerCount > 1 and heads[layerCount - 1] == nullptr) {
+        layerCount--;
+    }
+}
+
+template <typename T, auto Hook, auto Key>
+T* IntrusiveSkipList<T, Hook, Key>::erase(const K& key) {
+    T* object{find(key)};
+    if (object != nullptr) {
+        erase(*object);
+    }
+    return object;
+}
+
+template <typename T, auto Hook, auto Key>
+T* IntrusiveSkipList<T, Hook, Key>::find(const K& key) const {
+    std::array<Links*, MAX_LAYERS> path;
+    T* found{searchPath(key, path)};
+    if (found == nullptr or not(keyOf(*found) == key)) {
+        return nullptr;
+    }
+    return found;
+}
+
+template <typename T, auto Hook, auto Key>
+size_t IntrusiveSkipList<T, Hook, Key>::height(const K& key) const {
+    T* object{find(key)};
+    if (object == nullptr) {
+        throw std::out_of_range("Key is not in the IntrusiveSkipList");
+    }
+    return hookOf(*object).height;
+}
+
+template <typename T, auto Hook, auto Key>
+void IntrusiveSkipList<T, Hook, Key>::clear() noexcept {
+    T* object{heads[0]};
+    while (object != nullptr) {
+        T* next{hookOf(*object).next[0]};
+        hookOf(*object) = HookType{};
+        object = next;
+    }
+    heads = Links{};
+    entries = 0;
+    layerCount = 1;
+}
+
+}  // namespace shindler::ics46::project2
+#endif
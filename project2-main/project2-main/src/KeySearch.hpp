@@ -0,0 +1,167 @@
+#ifndef ___KEY_SEARCH_HPP
+#define ___KEY_SEARCH_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Keys whose sorted arrays countLess() searches with vector compares:
+ * 32- and 64-bit integers, signed or not.
+ */
+template <typename K>
+concept SimdSearchableKey = std::integral<K> and (sizeof(K) == 4 or sizeof(K) == 8);
+
+/**
+ * @brief The instruction set countLess() was compiled to use: "avx2",
+ * "sse4.2", "sse2" or "scalar". Chosen by the compiler's target flags
+ * (e.g. -march=native), not at run time.
+ */
+inline constexpr const char* KEY_SEARCH_INSTRUCTION_SET{
+#if defined(__AVX2__)
+    "avx2"
+#elif defined(__SSE4_2__)
+    "sse4.2"
+#elif defined(__SSE2__)
+    "sse2"
+#else
+    "scalar"
+#endif
+};
+
+namespace detail {
+
+// One compare per key with no branch on the result, which the compiler
+// is free to vectorize for whatever target it has
+template <typename K>
+size_t countLessScalar(const K* keys, size_t count, K probe) noexcept {
+    size_t less{0};
+    for (size_t i = 0; i < count; i++) {
+        less += static_cast<size_t>(keys[i] < probe);
+    }
+    return less;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+// The integer compares below are signed; flipping the sign bit of both
+// sides turns them into unsigned ones
+template <typename K>
+constexpr int64_t signFlip() noexcept {
+    if constexpr (std::unsigned_integral<K>) {
+        return sizeof(K) == 4 ? int64_t{INT32_MIN} : INT64_MIN;
+    } else {
+        return 0;
+    }
+}
+#endif
+
+#if defined(__AVX2__)
+template <typename K>
+size_t countLessVector(const K* keys, size_t count, K probe) noexcept {
+    constexpr size_t LANES{32 / sizeof(K)};
+    __m256i flip;
+    __m256i target;
+    if constexpr (sizeof(K) == 4) {
+        flip = _mm256_set1_epi32(static_cast<int32_t>(signFlip<K>()));
+        target = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int32_t>(probe)), flip);
+    } else {
+        flip = _mm256_set1_epi64x(signFlip<K>());
+        target = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(probe)), flip);
+    }
+
+    size_t less{0};
+    size_t i{0};
+    for (; i + LANES <= count; i += LANES) {
+        __m256i block{_mm256_xor_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip)};
+        __m256i greater{sizeof(K) == 4 ? _mm256_cmpgt_epi32(target, block)
+                                       : _mm256_cmpgt_epi64(target, block)};
+        // Each lane that holds a smaller key sets sizeof(K) mask bits
+        less += static_cast<size_t>(std::popcount(
+                    static_cast<unsigned>(_mm256_movemask_epi8(greater)))) /
+                sizeof(K);
+    }
+    return less + countLessScalar(keys + i, count - i, probe);
+}
+#elif defined(__SSE2__)
+// SSE2 has no 64-bit compare; SSE4.2 adds one
+inline constexpr bool HAS_WIDE_COMPARE{
+#if defined(__SSE4_2__)
+    true
+#else
+    false
+#endif
+};
+
+template <typename K>
+size_t countLessVector(const K* keys, size_t count, K probe) noexcept {
+    if constexpr (sizeof(K) == 8 and not HAS_WIDE_COMPARE) {
+        return countLessScalar(keys, count, probe);
+    } else {
+        constexpr size_t LANES{16 / sizeof(K)};
+        __m128i flip;
+        __m128i target;
+        if constexpr (sizeof(K) == 4) {
+            flip = _mm_set1_epi32(static_cast<int32_t>(signFlip<K>()));
+            target = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(probe)), flip);
+        } else {
+            flip = _mm_set1_epi64x(signFlip<K>());
+            target = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(probe)), flip);
+        }
+
+        size_t less{0};
+        size_t i{0};
+        for (; i + LANES <= count; i += LANES) {
+            __m128i block{_mm_xor_si128(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), flip)};
+            __m128i greater;
+            if constexpr (sizeof(K) == 4) {
+                greater = _mm_cmpgt_epi32(target, block);
+            } else {
+                greater = _mm_cmpgt_epi64(target, block);
+            }
+            less += static_cast<size_t>(std::popcount(
+                        static_cast<unsigned>(_mm_movemask_epi8(greater)))) /
+                    sizeof(K);
+        }
+        return less + countLessScalar(keys + i, count - i, probe);
+    }
+}
+#else
+template <typename K>
+size_t countLessVector(const K* keys, size_t count, K probe) noexcept {
+    return countLessScalar(keys, count, probe);
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Number of the first *count* keys that are less than *probe*; for
+ * sorted keys, the index std::lower_bound would return.
+ *
+ * Integer keys are compared 8 (32-bit) or 4 (64-bit) at a time with AVX2,
+ * half that with SSE, and one at a time otherwise. Every key is looked at,
+ * so this suits short arrays such as an UnrolledSkipList block, where it
+ * trades the unpredictable branches of a binary search for a few vector
+ * compares. Other keys fall back to std::lower_bound.
+ */
+template <typename K>
+size_t countLess(const K* keys, size_t count, const K& probe) {
+    if constexpr (SimdSearchableKey<K>) {
+        return detail::countLessVector(keys, count, probe);
+    } else {
+        return static_cast<size_t>(std::lower_bound(keys, keys + count, probe) - keys);
+    }
+}
+
+}  // namespace shindler::ics46::project2
+#endif
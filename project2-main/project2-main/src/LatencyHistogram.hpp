@@ -0,0 +1,360 @@
+#ifndef ___LATENCY_HISTOGRAM_HPP
+#define ___LATENCY_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Log-linear histogram of latencies in nanoseconds, in the style of
+ * HdrHistogram.
+ *
+ * Values below 2^SUB_BUCKET_BITS get a bucket each. Above that, every
+ * power of two is split into 2^SUB_BUCKET_BITS equal buckets, so a
+ * recorded value is known to within 1/32 (about 3%) at any magnitude, and
+ * the whole 64-bit range fits in a fixed array.
+ *
+ * One thread may record while others read or merge it: the buckets are
+ * relaxed atomics, so a reader sees every record up to some point, never a
+ * torn count. Recording from two threads at once loses counts; give each
+ * thread its own histogram (LatencyRecorder does).
+ */
+class LatencyHistogram {
+   public:
+    static constexpr size_t SUB_BUCKET_BITS{5};
+    static constexpr size_t SUB_BUCKETS{size_t{1} << SUB_BUCKET_BITS};
+    static constexpr size_t BUCKETS{(64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS};
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram& other) { merge(other); }
+
+    LatencyHistogram& operator=(const LatencyHistogram& other) {
+        if (this != &other) {
+            reset();
+            merge(other);
+        }
+        return *this;
+    }
+
+    void record(uint64_t nanoseconds) noexcept {
+        bump(buckets[bucketOf(nanoseconds)], 1);
+        bump(total, 1);
+        if (nanoseconds > largest.load(std::memory_order_relaxed)) {
+            largest.store(nanoseconds, std::memory_order_relaxed);
+        }
+        if (nanoseconds < smallest.load(std::memory_order_relaxed)) {
+            smallest.store(nanoseconds, std::memory_order_relaxed);
+        }
+    }
+
+    // Add every value recorded in *other* to this histogram.
+    void merge(const LatencyHistogram& other) noexcept {
+        for (size_t i = 0; i < BUCKETS; i++) {
+            bump(buckets[i], other.buckets[i].load(std::memory_order_relaxed));
+        }
+        bump(total, other.total.load(std::memory_order_relaxed));
+        largest.store(std::max(max(), other.max()), std::memory_order_relaxed);
+        smallest.store(std::min(smallest.load(std::memory_order_relaxed),
+                                other.smallest.load(std::memory_order_relaxed)),
+                       std::memory_order_relaxed);
+    }
+
+    void reset() noexcept {
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total.store(0, std::memory_order_relaxed);
+        largest.store(0, std::memory_order_relaxed);
+        smallest.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t count() const noexcept {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    // Exact extremes; 0 if nothing was recorded
+    [[nodiscard]] uint64_t max() const noexcept {
+        return largest.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t min() const noexcept {
+        return count() == 0 ? 0 : smallest.load(std::memory_order_relaxed);
+    }
+
+    // The smallest value that at least *percent* percent of the records are
+    // no greater than, rounded up to the top of its bucket (but never past
+    // max()). 0 if nothing was recorded.
+    [[nodiscard]] uint64_t percentile(double percent) const noexcept {
+        const uint64_t records{count()};
+        if (records == 0) {
+            return 0;
+        }
+        double wanted{percent / 100.0 * static_cast<double>(records)};
+        auto rank = std::clamp<uint64_t>(static_cast<uint64_t>(wanted), 1, records);
+        if (static_cast<double>(rank) < wanted and rank < records) {
+            rank++;
+        }
+
+        uint64_t seen{0};
+        for (size_t i = 0; i < BUCKETS; i++) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(highestInBucket(i), max());
+            }
+        }
+        return max();
+    }
+
+    // Write count, p50, p90, p99, p99.9, p99.99 and max on one line.
+    void writePercentiles(std::ostream& out) const {
+        out << "count=" << count() << " p50=" << percentile(50)
+            << "ns p90=" << percentile(90) << "ns p99=" << percentile(99)
+            << "ns p99.9=" << percentile(99.9) << "ns p99.99=" << percentile(99.99)
+            << "ns max=" << max() << "ns";
+    }
+
+    // Bucket index of *value*
+    static constexpr size_t bucketOf(uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        const auto exponent = static_cast<size_t>(std::bit_width(value)) - 1;
+        const size_t shift{exponent - SUB_BUCKET_BITS};
+        return (shift + 1) * SUB_BUCKETS + static_cast<size_t>(value >> shift) - SUB_BUCKETS;
+    }
+
+    // Largest value that lands in bucket *index*
+    static constexpr uint64_t highestInBucket(size_t index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const size_t shift{index / SUB_BUCKETS - 1};
+        const uint64_t lowest{static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS)
+                              << shift};
+        return lowest + ((uint64_t{1} << shift) - 1);
+    }
+
+   private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> largest{0};
+    std::atomic<uint64_t> smallest{std::numeric_limits<uint64_t>::max()};
+
+    // Only the owning thread writes, so a load and store is enough and
+    // avoids a locked read-modify-write on the hot path
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + amount,
+                      std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief The operations a SkipList with RECORD_LATENCY set times.
+ * Find covers find and contains; RangeScan is a whole parallelForEach or
+ * parallelReduce call.
+ */
+enum class LatencyOperation : uint8_t { Find, Insert, Erase, RangeScan };
+
+inline constexpr size_t LATENCY_OPERATIONS{4};
+
+inline const char* latencyOperationName(LatencyOperation operation) noexcept {
+    switch (operation) {
+        case LatencyOperation::Find:
+            return "find";
+        case LatencyOperation::Insert:
+            return "insert";
+        case LatencyOperation::Erase:
+            return "erase";
+        case LatencyOperation::RangeScan:
+            return "range_scan";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief A LatencyHistogram per operation per thread.
+ *
+ * Each thread that records gets its own set of histograms the first time it
+ * records, so recording takes no lock and touches no shared cache line.
+ * histogram() merges every thread's histograms for one operation on demand.
+ *
+ * A thread finds its histograms through a thread_local map from recorder
+ * id, checking the recorder it used last first. Entries for recorders that
+ * have since been destroyed are pruned whenever the map has doubled, so
+ * threads that outlive many short-lived lists neither leak nor slow down.
+ */
+class LatencyRecorder {
+   public:
+    LatencyRecorder() : id{registerRecorder()} {}
+
+    ~LatencyRecorder() {
+        Registry& registry{liveRecorders()};
+        std::lock_guard<std::mutex> guard{registry.lock};
+        registry.ids.erase(id);
+    }
+
+    LatencyRecorder(const LatencyRecorder&) = delete;
+    LatencyRecorder(LatencyRecorder&&) = delete;
+    LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+    LatencyRecorder& operator=(LatencyRecorder&&) = delete;
+
+    void record(LatencyOperation operation, uint64_t nanoseconds) {
+        localSlot().histograms[static_cast<size_t>(operation)].record(nanoseconds);
+    }
+
+    // Every thread's records for *operation*, merged.
+    [[nodiscard]] LatencyHistogram histogram(LatencyOperation operation) const {
+        LatencyHistogram merged;
+        std::lock_guard<std::mutex> guard{lock};
+        for (const auto& slot : slots) {
+            merged.merge(slot->histograms[static_cast<size_t>(operation)]);
+        }
+        return merged;
+    }
+
+    // Drop every record. Records made by other threads while this runs may
+    // or may not survive it.
+    void reset() {
+        std::lock_guard<std::mutex> guard{lock};
+        for (const auto& slot : slots) {
+            for (auto& histogram : slot->histograms) {
+                histogram.reset();
+            }
+        }
+    }
+
+    // Recorders the calling thread still holds histograms for, destroyed
+    // ones included until they are pruned.
+    [[nodiscard]] static size_t threadCacheSize() { return threadCache().slots.size(); }
+
+    // One line of percentiles per operation that has records.
+    void writePercentiles(std::ostream& out) const {
+        for (size_t i = 0; i < LATENCY_OPERATIONS; i++) {
+            auto operation = static_cast<LatencyOperation>(i);
+            LatencyHistogram merged{histogram(operation)};
+            if (merged.count() > 0) {
+                out << latencyOperationName(operation) << ": ";
+                merged.writePercentiles(out);
+                out << "\n";
+            }
+        }
+    }
+
+   private:
+    struct Slot {
+        std::array<LatencyHistogram, LATENCY_OPERATIONS> histograms;
+    };
+
+    // Ids of the recorders not yet destroyed
+    struct Registry {
+        std::mutex lock;
+        std::unordered_set<uint64_t> ids;
+        uint64_t lastId{0};
+    };
+
+    struct ThreadCache {
+        std::unordered_map<uint64_t, Slot*> slots;
+        size_t pruneAt{16};
+        uint64_t lastId{0};
+        Slot* lastSlot{nullptr};
+    };
+
+    // Recorders are told apart by id rather than address, so a thread's
+    // cached slot for a destroyed recorder can never be mistaken for one
+    // belonging to a new recorder at the same address.
+    uint64_t id;
+    mutable std::mutex lock;
+    std::vector<std::unique_ptr<Slot>> slots;
+
+    static Registry& liveRecorders() {
+        static Registry registry;
+        return registry;
+    }
+
+    static ThreadCache& threadCache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    static uint64_t registerRecorder() {
+        Registry& registry{liveRecorders()};
+        std::lock_guard<std::mutex> guard{registry.lock};
+        registry.ids.insert(++registry.lastId);
+        return registry.lastId;
+    }
+
+    Slot& localSlot() {
+        ThreadCache& cache{threadCache()};
+        if (cache.lastId == id) {
+            return *cache.lastSlot;
+        }
+
+        auto found = cache.slots.find(id);
+        if (found == cache.slots.end()) {
+            if (cache.slots.size() >= cache.pruneAt) {
+                prune(cache);
+            }
+            std::lock_guard<std::mutex> guard{lock};
+            slots.push_back(std::make_unique<Slot>());
+            found = cache.slots.emplace(id, slots.back().get()).first;
+        }
+        cache.lastId = id;
+        cache.lastSlot = found->second;
+        return *cache.lastSlot;
+    }
+
+    // Drop the entries of destroyed recorders. The next prune waits until
+    // the map has doubled again, so pruning costs O(1) per new entry.
+    static void prune(ThreadCache& cache) {
+        Registry& registry{liveRecorders()};
+        {
+            std::lock_guard<std::mutex> guard{registry.lock};
+            std::erase_if(cache.slots, [&](const auto& entry) {
+                return not registry.ids.contains(entry.first);
+            });
+        }
+        cache.pruneAt = std::max<size_t>(16, 2 * cache.slots.size());
+    }
+};
+
+/**
+ * @brief Records the time from its construction to its destruction into a
+ * LatencyRecorder, including when the scope is left by an exception.
+ */
+class ScopedLatency {
+   public:
+    ScopedLatency(LatencyRecorder& recorder, LatencyOperation operation)
+        : recorder{recorder}, operation{operation}, start{std::chrono::steady_clock::now()} {}
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    ~ScopedLatency() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        recorder.record(operation, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+   private:
+    LatencyRecorder& recorder;
+    LatencyOperation operation;
+    std::chrono::steady_clock::time_point start;
+};
+
+}  // namespace shindler::ics46::project2
+#endif
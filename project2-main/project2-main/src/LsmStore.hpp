@@ -0,0 +1,798 @@
+#ifndef ___LSM_STORE_HPP
+#define ___LSM_STORE_HPP
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "BinaryIO.hpp"
+#include "SkipList.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Tuning knobs of an LsmStore.
+ *
+ * The memtable is frozen and flushed once it holds *memtableMaxKeys* keys
+ * or its estimated footprint reaches *memtableMaxBytes*. Sorted runs keep
+ * every *indexInterval*-th key in their sparse index, so a lookup reads at
+ * most that many entries, and a bloom filter with *bloomBitsPerKey* bits
+ * per key (about 1% false positives at 10). Every option must be at
+ * least 1.
+ */
+struct LsmOptions {
+    size_t memtableMaxKeys{size_t{1} << 16};
+    size_t memtableMaxBytes{size_t{64} << 20};
+    size_t indexInterval{16};
+    size_t bloomBitsPerKey{10};
+};
+
+// What the memtable and the sorted runs store for a key: its value, or a
+// tombstone saying the key was erased and older runs must not be consulted.
+template <typename V>
+struct LsmEntry {
+    V value{};
+    bool erased{false};
+};
+
+/**
+ * @brief Hash of a key's encoded bytes. Unlike std::hash it is the same in
+ * every build, which matters because bloom filters are stored on disk.
+ */
+template <typename K>
+uint64_t lsmKeyHash(const K& key) {
+    Fnv1a hash;
+    if constexpr (std::is_trivially_copyable_v<K>) {
+        hash.update(&key, sizeof(K));
+    } else {
+        std::string encoded;
+        BufferWriter writer{encoded};
+        BinaryCodec<K>::write(writer, &key, 1);
+        hash.update(encoded.data(), encoded.size());
+    }
+    return hash.digest();
+}
+
+/**
+ * @brief Bloom filter over key hashes, probed with double hashing.
+ */
+class BloomFilter {
+   public:
+    BloomFilter() = default;
+
+    BloomFilter(size_t keys, size_t bitsPerKey)
+        : words((std::max<size_t>(keys, 1) * bitsPerKey + 63) / 64, 0),
+          hashes{static_cast<uint32_t>(
+              std::clamp<size_t>(bitsPerKey * 69 / 100, 1, 30))} {}
+
+    void add(uint64_t hash) {
+        for (uint32_t i = 0; i < hashes; i++) {
+            uint64_t bit{probe(hash, i)};
+            words[bit / 64] |= uint64_t{1} << (bit % 64);
+        }
+    }
+
+    [[nodiscard]] bool mayContain(uint64_t hash) const {
+        for (uint32_t i = 0; i < hashes; i++) {
+            uint64_t bit{probe(hash, i)};
+            if ((words[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void write(BinaryWriter& writer) const {
+        writer.writeValue(static_cast<uint64_t>(words.size()));
+        writer.writeValue(hashes);
+        writer.write(words.data(), words.size() * sizeof(uint64_t));
+    }
+
+    void read(BinaryReader& reader) {
+        auto count = static_cast<size_t>(reader.readValue<uint64_t>());
+        hashes = reader.readValue<uint32_t>();
+        if (count == 0 or count > reader.remaining() / sizeof(uint64_t)) {
+            throw std::runtime_error("Bloom filter runs past the end");
+        }
+        words.resize(count);
+        reader.read(words.data(), count * sizeof(uint64_t));
+    }
+
+   private:
+    std::vector<uint64_t> words;
+    uint32_t hashes{1};
+
+    [[nodiscard]] uint64_t probe(uint64_t hash, uint32_t i) const {
+        // The high half is made odd so that the probes never all coincide
+        uint64_t step{(hash >> 32) | 1};
+        return (hash + i * step) % (words.size() * 64);
+    }
+};
+
+/**
+ * @brief Immutable sorted file of keys and LsmEntry values.
+ *
+ * File layout (BinaryCodec encoding, native byte order):
+ *
+ *   magic, version
+ *   entries             erased flag, key, then value unless erased
+ *   sparse index        count, then (key, offset of entry) for every
+ *                       indexInterval-th entry
+ *   bloom filter
+ *   footer              entry count, offset of the index, offset of the
+ *                       bloom filter
+ *   checksum            FNV-1a of everything before it
+ *
+ * The index and filter are kept in memory; a lookup that passes the filter
+ * reads the one block of at most indexInterval entries that could hold the
+ * key with a single pread.
+ */
+template <typename K, typename V>
+class SortedRun {
+   public:
+    enum class Lookup { Missing, Found, Erased };
+
+    // Write the entries that *produce* emits, in increasing key order, to
+    // *path* and return the run. *expectedKeys* sizes the bloom filter.
+    // produce is called as produce(emit) and calls emit(key, entry).
+    template <typename Produce>
+    static std::shared_ptr<SortedRun> write(const std::string& path,
+                                            size_t expectedKeys,
+                                            const LsmOptions& options,
+                                            Produce&& produce);
+
+    // Open a run written by write, checking its checksum. Throw a
+    // std::runtime_error if it cannot be read or is corrupt.
+    explicit SortedRun(const std::string& path);
+
+    SortedRun(const SortedRun&) = delete;
+    SortedRun(SortedRun&&) = delete;
+    SortedRun& operator=(const SortedRun&) = delete;
+    SortedRun& operator=(SortedRun&&) = delete;
+
+    ~SortedRun() { ::close(fd); }
+
+    [[nodiscard]] size_t size() const noexcept { return entryCount; }
+
+    // Look *key* up, filling *value* if it is Found.
+    Lookup lookup(const K& key, V& value) const;
+
+    // Reads a run's entries in order, one index block at a time.
+    class Cursor {
+       public:
+        explicit Cursor(const SortedRun& run) : run{run} { advance(); }
+
+        [[nodiscard]] bool valid() const noexcept { return isValid; }
+        [[nodiscard]] const K& key() const noexcept { return currentKey; }
+        [[nodiscard]] const LsmEntry<V>& entry() const noexcept {
+            return currentEntry;
+        }
+
+        void advance() {
+            while (reader.remaining() == 0) {
+                if (nextBlock == run.index.size()) {
+                    isValid = false;
+                    return;
+                }
+                bytes = run.readBlock(nextBlock++);
+                reader = BufferReader{bytes.data(), bytes.size()};
+            }
+            readEntry(reader, currentKey, currentEntry);
+            isValid = true;
+        }
+
+       private:
+        const SortedRun& run;
+        size_t nextBlock{0};
+        std::string bytes;
+        BufferReader reader{nullptr, 0};
+        K currentKey{};
+        LsmEntry<V> currentEntry;
+        bool isValid{false};
+    };
+
+   private:
+    static constexpr uint64_t RUN_MAGIC{0x314e5552534b5350ULL};  // "PSKRUN1"
+    static constexpr uint32_t RUN_VERSION{1};
+    static constexpr size_t FOOTER_BYTES{4 * sizeof(uint64_t)};
+
+    struct IndexEntry {
+        K key;
+        uint64_t offset;
+    };
+
+    int fd{-1};
+    std::string path;
+    size_t entryCount{0};
+    uint64_t indexOffset{0};
+    std::vector<IndexEntry> index;
+    BloomFilter bloom;
+
+    SortedRun(const std::string& path, size_t entryCount, uint64_t indexOffset,
+              std::vector<IndexEntry> index, BloomFilter bloom);
+
+    void openFile();
+    std::string readBlock(size_t block) const;
+
+    static void readEntry(BufferReader& reader, K& key, LsmEntry<V>& entry) {
+        entry.erased = reader.readValue<uint8_t>() != 0;
+        BinaryCodec<K>::read(reader, &key, 1);
+        if (not entry.erased) {
+            BinaryCodec<V>::read(reader, &entry.value, 1);
+        }
+    }
+};
+
+template <typename K, typename V>
+template <typename Produce>
+std::shared_ptr<SortedRun<K, V>> SortedRun<K, V>::write(const std::string& path,
+                                                        size_t expectedKeys,
+                                                        const LsmOptions& options,
+                                                        Produce&& produce) {
+    BinaryWriter writer{path};
+    writer.writeValue(RUN_MAGIC);
+    writer.writeValue(RUN_VERSION);
+
+    size_t count{0};
+    std::vector<IndexEntry> index;
+    BloomFilter bloom{expectedKeys, options.bloomBitsPerKey};
+    produce([&](const K& key, const LsmEntry<V>& entry) {
+        if (count % options.indexInterval == 0) {
+            index.push_back({key, writer.position()});
+        }
+        bloom.add(lsmKeyHash(key));
+        writer.writeValue(static_cast<uint8_t>(entry.erased));
+        BinaryCodec<K>::write(writer, &key, 1);
+        if (not entry.erased) {
+            BinaryCodec<V>::write(writer, &entry.value, 1);
+        }
+        count++;
+    });
+
+    const uint64_t indexOffset{writer.position()};
+    writer.writeValue(static_cast<uint64_t>(index.size()));
+    for (const IndexEntry& entry : index) {
+        BinaryCodec<K>::write(writer, &entry.key, 1);
+        writer.writeValue(entry.offset);
+    }
+    const uint64_t bloomOffset{writer.position()};
+    bloom.write(writer);
+    writer.writeValue(static_cast<uint64_t>(count));
+    writer.writeValue(indexOffset);
+    writer.writeValue(bloomOffset);
+    writer.finish();
+
+    return std::shared_ptr<SortedRun>{
+        new SortedRun{path, count, indexOffset, std::move(index), std::move(bloom)}};
+}
+
+template <typename K, typename V>
+SortedRun<K, V>::SortedRun(const std::string& path, size_t entryCount,
+                           uint64_t indexOffset, std::vector<IndexEntry> index,
+                           BloomFilter bloom)
+    : path{path},
+      entryCount{entryCount},
+      indexOffset{indexOffset},
+      index{std::move(index)},
+      bloom{std::move(bloom)} {
+    openFile();
+}
+
+template <typename K, typename V>
+SortedRun<K, V>::SortedRun(const std::string& path) : path{path} {
+    // The footer says where the sections start; everything, including the
+    // entries, is then read once to check the checksum.
+    uint64_t footer[3]{};
+    {
+        std::ifstream tail{path, std::ios::binary | std::ios::ate};
+        if (not tail or static_cast<size_t>(tail.tellg()) < FOOTER_BYTES) {
+            throw std::runtime_error("Cannot read sorted run " + path);
+        }
+        tail.seekg(-static_cast<std::streamoff>(FOOTER_BYTES), std::ios::end);
+        tail.read(reinterpret_cast<char*>(footer), sizeof(footer));
+    }
+    entryCount = static_cast<size_t>(footer[0]);
+    indexOffset = footer[1];
+
+    BinaryReader reader{path};
+    if (reader.readValue<uint64_t>() != RUN_MAGIC or
+        reader.readValue<uint32_t>() != RUN_VERSION) {
+        throw std::runtime_error(path + " is not a sorted run");
+    }
+    const size_t headerBytes{sizeof(RUN_MAGIC) + sizeof(RUN_VERSION)};
+    if (indexOffset < headerBytes or
+        indexOffset - headerBytes > reader.remaining()) {
+        throw std::runtime_error(path + " has a corrupt footer");
+    }
+    std::string entries(static_cast<size_t>(indexOffset) - headerBytes, '\0');
+    reader.read(entries.data(), entries.size());
+
+    auto indexCount = static_cast<size_t>(reader.readValue<uint64_t>());
+    if (indexCount > entryCount) {
+        throw std::runtime_error(path + " has a corrupt index");
+    }
+    index.resize(indexCount);
+    for (IndexEntry& entry : index) {
+        BinaryCodec<K>::read(reader, &entry.key, 1);
+        entry.offset = reader.readValue<uint64_t>();
+    }
+    bloom.read(reader);
+    for (size_t i = 0; i < 3; i++) {
+        (void)reader.readValue<uint64_t>();
+    }
+    reader.verifyChecksum();
+    openFile();
+}
+
+template <typename K, typename V>
+void SortedRun<K, V>::openFile() {
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open sorted run " + path);
+    }
+}
+
+template <typename K, typename V>
+std::string SortedRun<K, V>::readBlock(size_t block) const {
+    uint64_t begin{index[block].offset};
+    uint64_t end{block + 1 < index.size() ? index[block + 1].offset : indexOffset};
+    std::string bytes(static_cast<size_t>(end - begin), '\0');
+    size_t done{0};
+    while (done < bytes.size()) {
+        ssize_t got{::pread(fd, bytes.data() + done, bytes.size() - done,
+                            static_cast<off_t>(begin + done))};
+        if (got <= 0) {
+            throw std::runtime_error("Failed reading sorted run " + path);
+        }
+        done += static_cast<size_t>(got);
+    }
+    return bytes;
+}
+
+template <typename K, typename V>
+typename SortedRun<K, V>::Lookup SortedRun<K, V>::lookup(const K& key,
+                                                         V& value) const {
+    if (index.empty() or not bloom.mayContain(lsmKeyHash(key))) {
+        return Lookup::Missing;
+    }
+
+    // The block that could hold the key starts at the last index key <= key
+    auto after = std::upper_bound(
+        index.begin(), index.end(), key,
+        [](const K& lhs, const IndexEntry& rhs) { return lhs < rhs.key; });
+    if (after == index.begin()) {
+        return Lookup::Missing;
+    }
+    std::string bytes{readBlock(static_cast<size_t>(after - index.begin()) - 1)};
+
+    BufferReader reader{bytes.data(), bytes.size()};
+    K candidate{};
+    LsmEntry<V> entry;
+    while (reader.remaining() > 0) {
+        readEntry(reader, candidate, entry);
+        if (candidate == key) {
+            if (entry.erased) {
+                return Lookup::Erased;
+            }
+            value = std::move(entry.value);
+            return Lookup::Found;
+        }
+        if (key < candidate) {
+            break;
+        }
+    }
+    return Lookup::Missing;
+}
+
+/**
+ * @brief Log-structured key/value store with a SkipList as its memtable.
+ *
+ * Writes go to the memtable. Once it passes LsmOptions' size thresholds it
+ * is frozen into an immutable snapshot, a fresh memtable takes over, and a
+ * background thread writes the snapshot out as a SortedRun file in
+ * *directory*. A lookup checks the memtable, then the frozen memtable, then
+ * the runs from newest to oldest, and stops at the first one that knows the
+ * key; erases are recorded as tombstones so they hide older values.
+ * compact() merges all runs into one and drops the tombstones.
+ *
+ * Runs are named run-<sequence>-<generation>.sst. Flushes get increasing
+ * sequence numbers. A compacted run takes the sequence of the newest run it
+ * merged and a higher generation, so on reopening it sorts in the right
+ * place and the runs it replaced can be recognised and removed even if the
+ * compaction was interrupted.
+ *
+ * All functions may be called from several threads. The memtable is not
+ * logged: writes that have not been flushed are lost on a crash, and the
+ * destructor flushes them on a clean shutdown.
+ */
+template <typename K, typename V>
+class LsmStore {
+   public:
+    // Open the store in *directory*, creating it if needed, and load the
+    // runs already there. Throw a std::invalid_argument if an option is 0
+    // and a std::runtime_error if a run is corrupt.
+    explicit LsmStore(const std::string& directory, LsmOptions options = {});
+
+    LsmStore(const LsmStore&) = delete;
+    LsmStore(LsmStore&&) = delete;
+    LsmStore& operator=(const LsmStore&) = delete;
+    LsmStore& operator=(LsmStore&&) = delete;
+
+    ~LsmStore();
+
+    // Set the value of *key*, replacing any previous one.
+    void put(const K& key, const V& value);
+
+    // Remove *key*. Erasing a key that is not there is not an error.
+    void erase(const K& key);
+
+    // The newest value of *key*, or nothing if it was never put or erased.
+    [[nodiscard]] std::optional<V> get(const K& key) const;
+    [[nodiscard]] bool contains(const K& key) const { return get(key).has_value(); }
+
+    // Freeze the memtable if it holds anything and wait until everything
+    // frozen is on disk. Rethrows the error of a failed background flush.
+    void flush();
+
+    // Merge every run into one, dropping tombstones and shadowed values.
+    void compact();
+
+    [[nodiscard]] size_t runCount() const;
+
+   private:
+    using Memtable = SkipList<K, LsmEntry<V>>;
+
+    struct RunFile {
+        uint64_t sequence;
+        uint64_t generation;
+        std::string path;
+        std::shared_ptr<SortedRun<K, V>> run;
+    };
+
+    // Rough memory cost of one memtable entry besides its key and value:
+    // a base node plus one index node on average.
+    static constexpr size_t ENTRY_OVERHEAD_BYTES{2 * 4 * sizeof(void*)};
+
+    std::string directory;
+    LsmOptions options;
+
+    mutable std::mutex lock;
+    std::condition_variable flushDone;
+    std::unique_ptr<Memtable> memtable;
+    size_t memtableBytes{0};
+    std::shared_ptr<const Memtable> immutable;
+    // Newest first. Never changed in place: a flush or compaction swaps in
+    // a new list, so a reader takes the current one by copying a pointer.
+    std::shared_ptr<const std::vector<RunFile>> runs;
+    uint64_t nextSequence{1};
+    bool flushing{false};
+    std::exception_ptr flushError;
+    std::thread flusher;
+    std::mutex compactionLock;
+
+    std::string runPath(uint64_t sequence, uint64_t generation) const {
+        return (std::filesystem::path{directory} /
+                ("run-" + std::to_string(sequence) + "-" +
+                 std::to_string(generation) + ".sst"))
+            .string();
+    }
+
+    template <typename T>
+    static size_t encodedBytes(const T& item) {
+        if constexpr (std::is_same_v<T, std::string>) {
+            return sizeof(uint64_t) + item.size();
+        } else {
+            return sizeof(T);
+        }
+    }
+
+    void write(const K& key, const LsmEntry<V>& entry);
+    void freeze(std::unique_lock<std::mutex>& guard);
+    void waitForFlush(std::unique_lock<std::mutex>& guard);
+};
+
+template <typename K, typename V>
+LsmStore<K, V>::LsmStore(const std::string& directory, LsmOptions options)
+    : directory{directory}, options{options}, memtable{std::make_unique<Memtable>()} {
+    if (options.memtableMaxKeys == 0 or options.memtableMaxBytes == 0 or
+        options.indexInterval == 0 or options.bloomBitsPerKey == 0) {
+        throw std::invalid_argument("LsmOptions must all be at least 1");
+    }
+    std::filesystem::create_directories(directory);
+
+    std::vector<RunFile> found;
+    for (const auto& file : std::filesystem::directory_iterator{directory}) {
+        std::string name{file.path().filename().string()};
+        if (name.ends_with(".partial")) {
+            std::filesystem::remove(file.path());
+            continue;
+        }
+        size_t dash{name.find('-', 4)};
+        if (not name.starts_with("run-") or not name.ends_with(".sst") or
+            dash == std::string::npos) {
+            continue;
+        }
+        found.push_back({std::stoull(name.substr(4, dash - 4)),
+                         std::stoull(name.substr(dash + 1)), file.path().string(),
+                         nullptr});
+    }
+    std::sort(found.begin(), found.end(), [](const RunFile& lhs, const RunFile& rhs) {
+        return lhs.sequence != rhs.sequence ? lhs.sequence > rhs.sequence
+                                            : lhs.generation > rhs.generation;
+    });
+
+    // A run is left over from an interrupted compaction if a kept run of a
+    // later generation has a sequence at least as new
+    std::vector<RunFile> kept;
+    for (RunFile& file : found) {
+        bool replaced{std::any_of(kept.begin(), kept.end(), [&](const RunFile& newer) {
+            return newer.generation > file.generation and newer.sequence >= file.sequence;
+        })};
+        if (replaced) {
+            std::filesystem::remove(file.path);
+            continue;
+        }
+        file.run = std::make_shared<SortedRun<K, V>>(file.path);
+        nextSequence = std::max(nextSequence, file.sequence + 1);
+        kept.push_back(std::move(file));
+    }
+    runs = std::make_shared<const std::vector<RunFile>>(std::move(kept));
+}
+
+template <typename K, typename V>
+LsmStore<K, V>::~LsmStore() {
+    try {
+        flush();
+    } catch (...) {
+    }
+    std::unique_lock<std::mutex> guard{lock};
+    waitForFlush(guard);
+}
+
+template <typename K, typename V>
+void LsmStore<K, V>::put(const K& key, const V& value) {
+    write(key, LsmEntry<V>{value, false});
+}
+
+template <typename K, typename V>
+void LsmStore<K, V>::erase(const K& key) {
+    write(key, LsmEntry<V>{V{}, true});
+}
+
+template <typename K, typename V>
+void LsmStore<K, V>::write(const K& key, const LsmEntry<V>& entry) {
+    std::unique_lock<std::mutex> guard{lock};
+    if (flushError) {
+        std::rethrow_exception(flushError);
+    }
+
+    auto [position, inserted] = memtable->findOrInsert(key, entry);
+    if (inserted) {
+        memtableBytes += encodedBytes(key) + encodedBytes(entry.value) + ENTRY_OVERHEAD_BYTES;
+    } else {
+        // The footprint follows the value, which may grow or shrink
+        LsmEntry<V>& stored{memtable->mapped(position)};
+        memtableBytes = memtableBytes - encodedBytes(stored.value) + encodedBytes(entry.value);
+        stored = entry;
+    }
+
+    if (memtable->size() >= options.memtableMaxKeys or
+        memtableBytes >= options.memtableMaxBytes) {
+        freeze(guard);
+    }
+}
+
+template <typename K, typename V>
+void LsmStore<K, V>::waitForFlush(std::unique_lock<std::mutex>& guard) {
+    flushDone.wait(guard, [this]() { return not flushing; });
+    // Joined under the lock, so only one caller ever joins; the flusher
+    // takes the lock for the last time before it is marked done.
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+}
+
+template <typename K, typename V>
+void LsmStore<K, V>::freeze(std::unique_lock<std::mutex>& guard) {
+    // Only one frozen memtable at a time, which holds writers back if
+    // flushing cannot keep up
+    waitForFlush(guard);
+    if (flushError) {
+        std::rethrow_exception(flushError);
+    }
+
+    std::shared_ptr<const Memtable> frozen{std::move(memtable)};
+    memtable = std::make_unique<Memtable>();
+    memtableBytes = 0;
+    immutable = frozen;
+    flushing = true;
+
+    const uint64_t sequence{nextSequence++};
+    flusher = std::thread([this, frozen, sequence]() {
+        try {
+            const std::string path{runPath(sequence, 0)};
+            auto run = SortedRun<K, V>::write(
+                path + ".partial", frozen->size(), options, [&](auto&& emit) {
+                    for (auto [key, entry] : *frozen) {
+                        emit(key, entry);
+                    }
+                });
+            durableRename(path + ".partial", path);
+
+            std::lock_guard<std::mutex> flushGuard{lock};
+            auto flushed = std::make_shared<std::vector<RunFile>>();
+            flushed->reserve(runs->size() + 1);
+            flushed->push_back(RunFile{sequence, 0, path, std::move(run)});
+            flushed->insert(flushed->end(), runs->begin(), runs->end());
+            runs = std::move(flushed);
+            immutable.reset();
+            flushing = false;
+        } catch (...) {
+            // The frozen memtable stays readable; the error surfaces on the
+            // next write or flush
+            std::lock_guard<std::mutex> flushGuard{lock};
+            flushError = std::current_exception();
+            flushing = false;
+        }
+        flushDone.notify_all();
+    });
+}
+
+template <typename K, typename V>
+std::optional<V> LsmStore<K, V>::get(const K& key) const {
+    std::unique_lock<std::mutex> guard{lock};
+    auto found = memtable->lower_bound(key);
+    if (found != memtable->end() and (*found).first == key) {
+        const LsmEntry<V>& entry{(*found).second};
+        return entry.erased ? std::nullopt : std::optional<V>{entry.value};
+    }
+
+    // The frozen memtable and the runs are immutable, so they are searched
+    // without holding up writers
+    std::shared_ptr<const Memtable> frozen{immutable};
+    std::shared_ptr<const std::vector<RunFile>> searched{runs};
+    guard.unlock();
+
+    if (frozen != nullptr) {
+        found = frozen->lower_bound(key);
+        if (found != frozen->end() and (*found).first == key) {
+            const LsmEntry<V>& entry{(*found).second};
+            return entry.erased ? std::nullopt : std::optional<V>{entry.value};
+        }
+    }
+
+    V value{};
+    for (const RunFile& file : *searched) {
+        switch (file.run->lookup(key, value)) {
+            case SortedRun<K, V>::Lookup::Found:
+                return value;
+            case SortedRun<K, V>::Lookup::Erased:
+                return std::nullopt;
+            case SortedRun<K, V>::Lookup::Missing:
+                break;
+        }
+    }
+    return std::nullopt;
+}
+
+template <typename K, typename V>
+void LsmStore<K, V>::flush() {
+    std::unique_lock<std::mutex> guard{lock};
+    if (not memtable->empty()) {
+        freeze(guard);
+    }
+    waitForFlush(guard);
+    if (flushError) {
+        std::rethrow_exception(flushError);
+    }
+}
+
+template <typename K, typename V>
+void LsmStore<K, V>::compact() {
+    std::lock_guard<std::mutex> compactionGuard{compactionLock};
+
+    std::shared_ptr<const std::vector<RunFile>> inputs;
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        inputs = runs;
+    }
+    if (inputs->size() < 2) {
+        return;
+    }
+
+    // Runs flushed while this one is written are newer than all the inputs,
+    // so the merged run can keep the newest input's sequence
+    uint64_t generation{0};
+    size_t expectedKeys{0};
+    for (const RunFile& input : *inputs) {
+        generation = std::max(generation, input.generation + 1);
+        expectedKeys += input.run->size();
+    }
+    const uint64_t sequence{inputs->front().sequence};
+    const std::string path{runPath(sequence, generation)};
+
+    // k-way merge of the inputs. Cursors are ordered newest first, so among
+    // equal keys the first one found is the version that survives.
+    using Cursor = typename SortedRun<K, V>::Cursor;
+    std::vector<std::unique_ptr<Cursor>> cursors;
+    for (const RunFile& input : *inputs) {
+        cursors.push_back(std::make_unique<Cursor>(*input.run));
+    }
+    auto run = SortedRun<K, V>::write(
+        path + ".partial", expectedKeys, options, [&](auto&& emit) {
+            while (true) {
+                Cursor* newest{nullptr};
+                for (auto& cursor : cursors) {
+                    if (cursor->valid() and
+                        (newest == nullptr or cursor->key() < newest->key())) {
+                        newest = cursor.get();
+                    }
+                }
+                if (newest == nullptr) {
+                    break;
+                }
+
+                const K key{newest->key()};
+                if (not newest->entry().erased) {
+                    emit(key, newest->entry());
+                }
+                for (auto& cursor : cursors) {
+                    if (cursor->valid() and cursor->key() == key) {
+                        cursor->advance();
+                    }
+                }
+            }
+        });
+    // The inputs are only removed once the merged run is on disk under its
+    // final name; if the removals are lost, reopening removes them again
+    durableRename(path + ".partial", path);
+
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        auto isInput = [&](const RunFile& file) {
+            return std::any_of(inputs->begin(), inputs->end(),
+                               [&](const RunFile& input) { return input.path == file.path; });
+        };
+        // Runs flushed since the inputs were taken stay in front
+        auto compacted = std::make_shared<std::vector<RunFile>>();
+        bool placed{false};
+        for (const RunFile& file : *runs) {
+            if (not isInput(file)) {
+                compacted->push_back(file);
+            } else if (not placed) {
+                compacted->push_back(RunFile{sequence, generation, path, std::move(run)});
+                placed = true;
+            }
+        }
+        runs = std::move(compacted);
+    }
+    for (const RunFile& input : *inputs) {
+        std::filesystem::remove(input.path);
+    }
+    syncPath(directory);
+}
+
+template <typename K, typename V>
+size_t LsmStore<K, V>::runCount() const {
+    std::lock_guard<std::mutex> guard{lock};
+    return runs->size();
+}
+
+}  // namespace shindler::ics46::project2
+#endif
@@ -0,0 +1,440 @@
+#ifndef ___MAPPED_SKIP_LIST_HPP
+#define ___MAPPED_SKIP_LIST_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "BinaryIO.hpp"
+#include "SkipList.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Read-only skip list that is queried straight out of a memory
+ * mapped file.
+ *
+ * The file keeps the towers of the SkipList it was written from, but every
+ * link is a byte offset from the start of the file instead of a Node*, so
+ * the file can be mapped at any address and used without deserializing.
+ * Opening one only checks the header; pages are faulted in as queries touch
+ * them and are shared through the page cache by every process mapping the
+ * same file. Searches check each offset before following it, so a damaged
+ * file makes them throw rather than read outside the mapping or loop.
+ *
+ * File layout (native byte order, every section aligned to 64 bytes):
+ *
+ *   Header
+ *   Entry[size]         the base layer as one sorted array of key/value
+ *                       pairs, so the next node is simply the next entry
+ *   IndexNode[...]      layers 1 .. layers - 1, each starting with a head
+ *                       node that plays the part of the -inf sentinel
+ *   uint64_t            FNV-1a checksum of everything before it
+ *
+ * An IndexNode's next is the offset of the following node on its layer, or
+ * 0 at the end of the layer. Its down is the offset of the same key one
+ * layer below, which on layer 1 is the key's Entry. A head's down is the
+ * head of the layer below, or 0 on layer 1 meaning "before the first Entry".
+ *
+ * Keys and values must be trivially copyable.
+ */
+template <typename K, typename V>
+class MappedSkipList {
+    static_assert(std::is_trivially_copyable_v<K> and
+                      std::is_trivially_copyable_v<V>,
+                  "MappedSkipList stores keys and values as raw bytes");
+
+   private:
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t keyBytes;
+        uint32_t valueBytes;
+        uint32_t layers;
+        uint64_t size;
+        uint64_t entriesOffset;
+        uint64_t topHeadOffset;
+        uint64_t fileBytes;
+    };
+
+    struct Entry {
+        K key;
+        V value;
+    };
+
+    struct IndexNode {
+        K key;
+        uint64_t next;
+        uint64_t down;
+    };
+
+    static constexpr uint64_t MAPPED_MAGIC{0x3150414d4b5350ULL};  // "PSKMAP1"
+    static constexpr uint32_t MAPPED_VERSION{1};
+    static constexpr size_t SECTION_ALIGNMENT{64};
+
+    const std::byte* mapping{nullptr};
+    size_t mappingBytes{0};
+    const Header* header{nullptr};
+    const Entry* entries{nullptr};
+    // The index layers lie between the entries and the checksum
+    uint64_t indexBegin{0};
+    uint64_t indexEnd{0};
+
+    static size_t alignUp(size_t offset) {
+        return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT *
+               SECTION_ALIGNMENT;
+    }
+
+    [[noreturn]] static void throwCorrupt() {
+        throw std::runtime_error("Mapped skip list has an offset out of bounds");
+    }
+
+    // Only offsets of whole index nodes are followed
+    [[nodiscard]] const IndexNode& indexNode(uint64_t offset) const {
+        if (offset < indexBegin or offset >= indexEnd or
+            indexEnd - offset < sizeof(IndexNode) or
+            (offset - indexBegin) % sizeof(IndexNode) != 0) {
+            throwCorrupt();
+        }
+        return *reinterpret_cast<const IndexNode*>(mapping + offset);
+    }
+
+    // Index of the first entry whose key is not less than *key*
+    [[nodiscard]] size_t lowerBoundIndex(const K& key) const;
+
+   public:
+    // Forward iterator over the entries in increasing key order. Like
+    // SkipList::const_iterator it dereferences to a pair of references.
+    class const_iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = std::pair<const K&, const V&>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        reference operator*() const { return {entry->key, entry->value}; }
+
+        const_iterator& operator++() {
+            entry++;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous{*this};
+            entry++;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const = default;
+
+       private:
+        friend class MappedSkipList;
+        explicit const_iterator(const Entry* entry) : entry{entry} {}
+        const Entry* entry{nullptr};
+    };
+
+    // Write *skipList*, whatever its traits, to *path* in the mapped
+    // format. Throw a std::runtime_error if the file cannot be written.
+    template <typename Traits>
+    static void write(const SkipList<K, V, Traits>& skipList, const std::string& path);
+
+    // Map the file at *path*. Only the header is checked, so opening is
+    // constant time; call verify() to check the whole file. Throw a
+    // std::runtime_error if the file cannot be mapped or its header does not
+    // describe a file written by write() for these key and value types.
+    explicit MappedSkipList(const std::string& path);
+
+    MappedSkipList(const MappedSkipList&) = delete;
+    MappedSkipList(MappedSkipList&&) = delete;
+    MappedSkipList& operator=(const MappedSkipList&) = delete;
+    MappedSkipList& operator=(MappedSkipList&&) = delete;
+
+    ~MappedSkipList();
+
+    [[nodiscard]] size_t size() const noexcept { return header->size; }
+    [[nodiscard]] bool empty() const noexcept { return header->size == 0; }
+    [[nodiscard]] size_t layers() const noexcept { return header->layers; }
+
+    // Same contracts as the SkipList functions of the same name, except
+    // that every missing key is reported with a std::out_of_range. A search
+    // that meets a damaged offset throws a std::runtime_error.
+    [[nodiscard]] const V& find(const K& key) const;
+    [[nodiscard]] bool contains(const K& key) const;
+    [[nodiscard]] const K& nextKey(const K& key) const;
+    [[nodiscard]] const K& previousKey(const K& key) const;
+    [[nodiscard]] std::vector<K> allKeysInOrder() const;
+
+    [[nodiscard]] const_iterator begin() const;
+    [[nodiscard]] const_iterator end() const;
+    [[nodiscard]] const_iterator lower_bound(const K& key) const;
+
+    // Recompute the checksum over the whole mapping. Throw a
+    // std::runtime_error if it does not match the one stored in the file.
+    void verify() const;
+};
+
+template <typename K, typename V>
+template <typename Traits>
+void MappedSkipList<K, V>::write(const SkipList<K, V, Traits>& skipList,
+                                 const std::string& path) {
+    // Every key with height > 1 in order, with where its node on the layer
+    // currently being written will go
+    struct Promoted {
+        K key;
+        size_t height;
+        uint64_t downOffset;
+    };
+
+    const size_t layers{skipList.layers()};
+    const size_t entriesOffset{alignUp(sizeof(Header))};
+    const size_t indexOffset{
+        alignUp(entriesOffset + skipList.size() * sizeof(Entry))};
+
+    std::vector<Promoted> promoted;
+    std::vector<size_t> layerNodes(layers, 0);
+    size_t index{0};
+    for (auto it = skipList.begin(); it != skipList.end(); ++it, ++index) {
+        size_t height{it.height()};
+        if (height > 1) {
+            promoted.push_back(
+                {(*it).first, height, entriesOffset + index * sizeof(Entry)});
+        }
+        for (size_t layer = 1; layer < height; layer++) {
+            layerNodes[layer]++;
+        }
+    }
+
+    // Offsets of each layer's head, the nodes of a layer following its head
+    std::vector<uint64_t> heads(layers, 0);
+    size_t offset{indexOffset};
+    for (size_t layer = 1; layer < layers; layer++) {
+        heads[layer] = offset;
+        offset += (layerNodes[layer] + 1) * sizeof(IndexNode);
+    }
+    const size_t checksumOffset{offset};
+
+    Header fileHeader;
+    std::memset(&fileHeader, 0, sizeof(fileHeader));
+    fileHeader.magic = MAPPED_MAGIC;
+    fileHeader.version = MAPPED_VERSION;
+    fileHeader.keyBytes = sizeof(K);
+    fileHeader.valueBytes = sizeof(V);
+    fileHeader.layers = static_cast<uint32_t>(layers);
+    fileHeader.size = skipList.size();
+    fileHeader.entriesOffset = entriesOffset;
+    fileHeader.topHeadOffset = heads[layers - 1];
+    fileHeader.fileBytes = checksumOffset + sizeof(uint64_t);
+
+    const std::vector<std::byte> padding(SECTION_ALIGNMENT, std::byte{0});
+    BinaryWriter writer{path};
+    writer.writeValue(fileHeader);
+    writer.write(padding.data(), entriesOffset - sizeof(Header));
+
+    // Zeroed first so that padding bytes inside the records are
+    // deterministic and the checksum is reproducible
+    Entry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    for (auto [key, value] : skipList) {
+        entry.key = key;
+        entry.value = value;
+        writer.writeValue(entry);
+    }
+    writer.write(padding.data(),
+                 indexOffset - entriesOffset - skipList.size() * sizeof(Entry));
+
+    // layerNodes counts down as nodes are written, so the last node of a
+    // layer is the one that brings it to zero
+    IndexNode node;
+    std::memset(&node, 0, sizeof(node));
+    for (size_t layer = 1; layer < layers; layer++) {
+        uint64_t nodeOffset{heads[layer] + sizeof(IndexNode)};
+
+        node.next = layerNodes[layer] == 0 ? 0 : nodeOffset;
+        node.down = heads[layer - 1];
+        writer.writeValue(node);
+
+        for (Promoted& key : promoted) {
+            if (key.height <= layer) {
+                continue;
+            }
+            layerNodes[layer]--;
+            node.key = key.key;
+            node.next = layerNodes[layer] == 0 ? 0 : nodeOffset + sizeof(IndexNode);
+            node.down = key.downOffset;
+            writer.writeValue(node);
+
+            // The layer above links down to this node
+            key.downOffset = nodeOffset;
+            nodeOffset += sizeof(IndexNode);
+        }
+    }
+    writer.finish();
+}
+
+template <typename K, typename V>
+MappedSkipList<K, V>::MappedSkipList(const std::string& path) {
+    int fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0 or
+        static_cast<size_t>(status.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is too small to be a mapped skip list");
+    }
+
+    mappingBytes = static_cast<size_t>(status.st_size);
+    void* address{::mmap(nullptr, mappingBytes, PROT_READ, MAP_SHARED, fd, 0)};
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+    mapping = static_cast<const std::byte*>(address);
+    header = reinterpret_cast<const Header*>(mapping);
+
+    // Sizes are compared by division so that huge ones cannot overflow
+    if (header->magic != MAPPED_MAGIC or header->version != MAPPED_VERSION or
+        header->keyBytes != sizeof(K) or header->valueBytes != sizeof(V) or
+        header->fileBytes != mappingBytes or header->layers < 2 or
+        mappingBytes < sizeof(Header) + sizeof(uint64_t) or
+        header->entriesOffset != alignUp(sizeof(Header)) or
+        header->size > (mappingBytes - header->entriesOffset) / sizeof(Entry)) {
+        ::munmap(address, mappingBytes);
+        throw std::runtime_error(path + " is not a mapped skip list of this type");
+    }
+    entries = reinterpret_cast<const Entry*>(mapping + header->entriesOffset);
+    indexBegin = alignUp(header->entriesOffset + header->size * sizeof(Entry));
+    indexEnd = mappingBytes - sizeof(uint64_t);
+    if (indexBegin > indexEnd or header->topHeadOffset < indexBegin or
+        header->topHeadOffset >= indexEnd or
+        indexEnd - header->topHeadOffset < sizeof(IndexNode)) {
+        ::munmap(address, mappingBytes);
+        throw std::runtime_error(path + " is not a mapped skip list of this type");
+    }
+}
+
+template <typename K, typename V>
+MappedSkipList<K, V>::~MappedSkipList() {
+    ::munmap(const_cast<std::byte*>(mapping), mappingBytes);
+}
+
+template <typename K, typename V>
+size_t MappedSkipList<K, V>::lowerBoundIndex(const K& key) const {
+    // Descend the index layers to the last key on layer 1 that is smaller.
+    // Each layer is written in key order, so a next that does not lead
+    // further into the file is damage, and would otherwise loop forever.
+    uint64_t offset{header->topHeadOffset};
+    for (size_t layer = header->layers - 1; layer > 0; layer--) {
+        uint64_t next{indexNode(offset).next};
+        while (next != 0 and indexNode(next).key < key) {
+            if (next <= offset) {
+                throwCorrupt();
+            }
+            offset = next;
+            next = indexNode(offset).next;
+        }
+        offset = indexNode(offset).down;
+    }
+
+    // Then walk the base layer, which is contiguous, from that entry on
+    if (offset != 0 and (offset < header->entriesOffset or offset >= indexBegin or
+                         (offset - header->entriesOffset) % sizeof(Entry) != 0)) {
+        throwCorrupt();
+    }
+    size_t index{offset == 0 ? 0
+                             : (offset - header->entriesOffset) / sizeof(Entry)};
+    while (index < header->size and entries[index].key < key) {
+        index++;
+    }
+    return index;
+}
+
+template <typename K, typename V>
+const V& MappedSkipList<K, V>::find(const K& key) const {
+    size_t index{lowerBoundIndex(key)};
+    if (index == header->size or not(entries[index].key == key)) {
+        throw std::out_of_range("Key not found");
+    }
+    return entries[index].value;
+}
+
+template <typename K, typename V>
+bool MappedSkipList<K, V>::contains(const K& key) const {
+    size_t index{lowerBoundIndex(key)};
+    return index < header->size and entries[index].key == key;
+}
+
+template <typename K, typename V>
+const K& MappedSkipList<K, V>::nextKey(const K& key) const {
+    size_t index{lowerBoundIndex(key)};
+    if (index + 1 >= header->size or not(entries[index].key == key)) {
+        throw std::out_of_range("No next key");
+    }
+    return entries[index + 1].key;
+}
+
+template <typename K, typename V>
+const K& MappedSkipList<K, V>::previousKey(const K& key) const {
+    size_t index{lowerBoundIndex(key)};
+    if (index == 0 or index == header->size or not(entries[index].key == key)) {
+        throw std::out_of_range("No previous key");
+    }
+    return entries[index - 1].key;
+}
+
+template <typename K, typename V>
+std::vector<K> MappedSkipList<K, V>::allKeysInOrder() const {
+    std::vector<K> keys;
+    keys.reserve(header->size);
+    for (size_t index = 0; index < header->size; index++) {
+        keys.push_back(entries[index].key);
+    }
+    return keys;
+}
+
+template <typename K, typename V>
+typename MappedSkipList<K, V>::const_iterator MappedSkipList<K, V>::begin()
+    const {
+    return const_iterator{entries};
+}
+
+template <typename K, typename V>
+typename MappedSkipList<K, V>::const_iterator MappedSkipList<K, V>::end() const {
+    return const_iterator{entries + header->size};
+}
+
+template <typename K, typename V>
+typename MappedSkipList<K, V>::const_iterator MappedSkipList<K, V>::lower_bound(
+    const K& key) const {
+    return const_iterator{entries + lowerBoundIndex(key)};
+}
+
+template <typename K, typename V>
+void MappedSkipList<K, V>::verify() const {
+    Fnv1a checksum;
+    checksum.update(mapping, mappingBytes - sizeof(uint64_t));
+    uint64_t stored{0};
+    std::memcpy(&stored, mapping + mappingBytes - sizeof(uint64_t),
+                sizeof(stored));
+    if (stored != checksum.digest()) {
+        throw std::runtime_error("Mapped skip list failed its checksum");
+    }
+}
+
+}  // namespace shindler::ics46::project2
+#endif
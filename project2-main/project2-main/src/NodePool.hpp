@@ -0,0 +1,283 @@
+#ifndef ___NODE_POOL_HPP
+#define ___NODE_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Storage for T objects carved out of large chunks, which are freed
+ * together rather than one object at a time.
+ *
+ * create() constructs an object in a free slot, taking a new chunk when
+ * there is none, and destroy() destroys it and frees the slot for the next
+ * create(). reserve() sets aside room ahead of time, so later creates do
+ * not call the global allocator, and shrinkToFit() releases chunks none of
+ * whose slots are in use. reset() frees every slot at once without
+ * destroying anything, for objects that are already destroyed or need no
+ * destructor.
+ *
+ * Chunks double from 8 slots until they reach about 4 KiB and stay that
+ * size from then on, so a pool that grows by create() alone never holds
+ * more than one chunk's worth of slots it has not used.
+ *
+ * Chunks are reference counted. share() lets a pool hold on to another
+ * pool's chunk, so an object can move from one pool to the other and be
+ * destroyed by its new pool; a chunk is released when the last pool
+ * holding it lets it go.
+ *
+ * There is no lock: one thread at a time per pool.
+ */
+template <typename T>
+class NodePool {
+   public:
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    NodePool(NodePool&& other) noexcept
+        : chunks{std::exchange(other.chunks, {})},
+          freeList{std::exchange(other.freeList, nullptr)},
+          freeSlots{std::exchange(other.freeSlots, 0)},
+          unused{std::exchange(other.unused, {})},
+          unusedSlots{std::exchange(other.unusedSlots, 0)},
+          capacitySlots{std::exchange(other.capacitySlots, 0)} {}
+
+    // Chunks this pool held are let go, so objects in them must already be
+    // destroyed or belong to another pool sharing the chunk.
+    NodePool& operator=(NodePool&& other) noexcept {
+        chunks = std::exchange(other.chunks, {});
+        freeList = std::exchange(other.freeList, nullptr);
+        freeSlots = std::exchange(other.freeSlots, 0);
+        unused = std::exchange(other.unused, {});
+        unusedSlots = std::exchange(other.unusedSlots, 0);
+        capacitySlots = std::exchange(other.capacitySlots, 0);
+        return *this;
+    }
+
+    // Make sure at least *count* objects can be created without the global
+    // allocator.
+    void reserve(size_t count) {
+        if (count > available()) {
+            addChunk(count - available());
+        }
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot{takeSlot()};
+        try {
+            return ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            giveSlot(slot);
+            throw;
+        }
+    }
+
+    void destroy(T* object) noexcept {
+        object->~T();
+        giveSlot(reinterpret_cast<Slot*>(object));
+    }
+
+    // Is *object* in one of the chunks this pool holds?
+    [[nodiscard]] bool owns(const T* object) const noexcept {
+        return findChunk(reinterpret_cast<const Slot*>(object)) != nullptr;
+    }
+
+    // Hold on to the chunk of *other* that *object* is in, so that this
+    // pool can destroy it.
+    void share(const NodePool& other, const T* object) {
+        const auto* slot = reinterpret_cast<const Slot*>(object);
+        const Chunk* chunk{other.findChunk(slot)};
+        if (chunk != nullptr and findChunk(slot) == nullptr) {
+            insertChunk(Chunk{chunk->slots, chunk->count});
+        }
+    }
+
+    // Take every chunk and free slot of *other*, leaving it empty.
+    void splice(NodePool& other) {
+        for (Chunk& chunk : other.chunks) {
+            if (findChunk(chunk.slots.get()) == nullptr) {
+                insertChunk(std::move(chunk));
+            }
+        }
+        while (other.freeList != nullptr) {
+            Slot* slot{other.freeList};
+            other.freeList = slot->nextFree;
+            giveSlot(slot);
+        }
+        unused.insert(unused.end(), other.unused.begin(), other.unused.end());
+        unusedSlots += other.unusedSlots;
+        other.chunks.clear();
+        other.capacitySlots = 0;
+        other.freeSlots = 0;
+        other.unused.clear();
+        other.unusedSlots = 0;
+    }
+
+    // Free every slot without destroying the objects in them. Chunks that
+    // another pool shares may hold that pool's objects, so they are let go
+    // rather than reused.
+    void reset() noexcept {
+        std::erase_if(chunks, [](const Chunk& chunk) { return chunk.slots.use_count() > 1; });
+        capacitySlots = 0;
+        freeList = nullptr;
+        freeSlots = 0;
+        unused.clear();
+        unusedSlots = 0;
+        for (const Chunk& chunk : chunks) {
+            unused.emplace_back(chunk.slots.get(), chunk.slots.get() + chunk.count);
+            unusedSlots += chunk.count;
+        }
+        capacitySlots = unusedSlots;
+    }
+
+    // Release every chunk whose slots are all free.
+    void shrinkToFit() {
+        std::vector<size_t> freeInChunk(chunks.size(), 0);
+        for (Slot* slot = freeList; slot != nullptr; slot = slot->nextFree) {
+            freeInChunk[indexOf(slot)]++;
+        }
+        for (const auto& [first, last] : unused) {
+            freeInChunk[indexOf(first)] += static_cast<size_t>(last - first);
+        }
+        auto released = [&](const Slot* slot) {
+            size_t chunk{indexOf(slot)};
+            return freeInChunk[chunk] == chunks[chunk].count;
+        };
+
+        Slot** link{&freeList};
+        while (*link != nullptr) {
+            if (released(*link)) {
+                *link = (*link)->nextFree;
+                freeSlots--;
+            } else {
+                link = &(*link)->nextFree;
+            }
+        }
+        std::erase_if(unused, [&](const std::pair<Slot*, Slot*>& range) {
+            if (released(range.first)) {
+                unusedSlots -= static_cast<size_t>(range.second - range.first);
+                return true;
+            }
+            return false;
+        });
+        size_t kept{0};
+        for (size_t chunk = 0; chunk < chunks.size(); chunk++) {
+            if (freeInChunk[chunk] != chunks[chunk].count) {
+                chunks[kept++] = std::move(chunks[chunk]);
+            } else {
+                capacitySlots -= chunks[chunk].count;
+            }
+        }
+        chunks.resize(kept);
+    }
+
+    // Objects that can be created before the pool needs another chunk, and
+    // bytes held in chunks whether or not their slots are in use
+    [[nodiscard]] size_t available() const noexcept { return freeSlots + unusedSlots; }
+    [[nodiscard]] size_t capacityBytes() const noexcept { return capacitySlots * sizeof(Slot); }
+
+   private:
+    union Slot {
+        Slot* nextFree;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    struct Chunk {
+        std::shared_ptr<Slot[]> slots;
+        size_t count;
+    };
+
+    // Chunks grow with the pool, so a small one stays small, up to about
+    // 4 KiB each, but never fewer than MIN_CHUNK_SLOTS slots. Bigger chunks
+    // would save little bookkeeping and leave up to their size unused.
+    static constexpr size_t MIN_CHUNK_SLOTS{8};
+    static constexpr size_t CHUNK_BYTES{size_t{1} << 12};
+    static constexpr size_t MAX_CHUNK_SLOTS{
+        std::max<size_t>(MIN_CHUNK_SLOTS, CHUNK_BYTES / sizeof(Slot))};
+
+    // Sorted by address, so a slot's chunk is found by binary search
+    std::vector<Chunk> chunks;
+    // Slots given back by destroy()
+    Slot* freeList{nullptr};
+    size_t freeSlots{0};
+    // Runs of slots never handed out since their chunk was added or reset
+    std::vector<std::pair<Slot*, Slot*>> unused;
+    size_t unusedSlots{0};
+    // Slots in all chunks
+    size_t capacitySlots{0};
+
+    const Chunk* findChunk(const Slot* slot) const noexcept {
+        std::less<const Slot*> less;
+        auto position = std::upper_bound(chunks.begin(), chunks.end(), slot,
+                                         [&less](const Slot* target, const Chunk& chunk) {
+                                             return less(target, chunk.slots.get());
+                                         });
+        if (position == chunks.begin()) {
+            return nullptr;
+        }
+        --position;
+        if (not less(slot, position->slots.get() + position->count)) {
+            return nullptr;
+        }
+        return &*position;
+    }
+
+    // Only for slots in this pool's chunks
+    size_t indexOf(const Slot* slot) const noexcept {
+        return static_cast<size_t>(findChunk(slot) - chunks.data());
+    }
+
+    void insertChunk(Chunk chunk) {
+        std::less<const Slot*> less;
+        auto position = std::upper_bound(chunks.begin(), chunks.end(), chunk.slots.get(),
+                                         [&less](const Slot* target, const Chunk& other) {
+                                             return less(target, other.slots.get());
+                                         });
+        capacitySlots += chunk.count;
+        chunks.insert(position, std::move(chunk));
+    }
+
+    void addChunk(size_t count) {
+        Chunk chunk{std::make_shared_for_overwrite<Slot[]>(count), count};
+        Slot* first{chunk.slots.get()};
+        insertChunk(std::move(chunk));
+        unused.emplace_back(first, first + count);
+        unusedSlots += count;
+    }
+
+    Slot* takeSlot() {
+        if (freeList != nullptr) {
+            Slot* slot{freeList};
+            freeList = slot->nextFree;
+            freeSlots--;
+            return slot;
+        }
+        if (unused.empty()) {
+            addChunk(std::clamp(capacitySlots, MIN_CHUNK_SLOTS, MAX_CHUNK_SLOTS));
+        }
+        auto& [first, last] = unused.back();
+        Slot* slot{first++};
+        if (first == last) {
+            unused.pop_back();
+        }
+        unusedSlots--;
+        return slot;
+    }
+
+    void giveSlot(Slot* slot) noexcept {
+        slot->nextFree = freeList;
+        freeList = slot;
+        freeSlots++;
+    }
+};
+
+}  // namespace shindler::ics46::project2
+#endif
@@ -0,0 +1,404 @@
+#ifndef ___SIMD_SKIP_LIST_HPP
+#define ___SIMD_SKIP_LIST_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "KeySearch.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Skip list for 32- and 64-bit integer keys whose layers keep their
+ * keys in contiguous arrays, so that each step down is one vector search.
+ *
+ * Every layer is a linked list of blocks. A block holds its keys in one
+ * array (structure of arrays) next to either the values, on the base
+ * layer, or the block below that each key starts, on the layers above.
+ * A key is promoted one layer with probability 1/FANOUT, and every key on
+ * a layer starts a block on the layer below it, so blocks hold FANOUT keys
+ * on average. Searching for a key takes, on each layer, the last key less
+ * than it in the one block the step above led to, found with countLess()
+ * (AVX2 or SSE where the target has them, a scalar loop otherwise), and
+ * never walks along a layer.
+ *
+ * Towers are built from a hash of the key, so the same keys always give
+ * the same shape, whatever order they are inserted in. Inserting a
+ * promoted key splits the block it lands in on every layer below its top,
+ * and erasing it merges them back.
+ *
+ * Values move when their block is split, merged or shifted, so iterators
+ * and references to values are only valid until the next insert or erase.
+ * V must be default constructible and not bool.
+ */
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+class SimdSkipList {
+    static_assert(not std::is_same_v<V, bool>,
+                  "std::vector<bool> cannot hand out references to values");
+
+   public:
+    // A key goes up a layer with probability 1 / FANOUT
+    static constexpr size_t FANOUT_BITS{4};
+    static constexpr size_t FANOUT{size_t{1} << FANOUT_BITS};
+    // FANOUT^16 is more keys than a 64-bit key can tell apart
+    static constexpr size_t MAX_LAYERS{16};
+
+   private:
+    struct Block {
+        std::vector<K> keys;
+        // Base layer only
+        std::vector<V> values;
+        // Layers above the base only: the block below starting with each key
+        std::vector<Block*> children;
+        Block* next{nullptr};
+    };
+
+    // The first layer's first block. Every layer above it starts with a
+    // block whose first key stands for minus infinity; it holds the
+    // smallest K, so countLess() counts it for every probe but that one.
+    std::vector<Block*> heads;
+    size_t entries{0};
+
+    using Path = std::array<Block*, MAX_LAYERS>;
+    using Positions = std::array<size_t, MAX_LAYERS>;
+
+    static size_t towerHeight(const K& key) noexcept;
+    void addTopLayer();
+    void descend(const K& key, Path& path, Positions& positions) const;
+    [[nodiscard]] std::pair<const Block*, size_t> lowerBound(const K& key) const;
+    // Throws a std::out_of_range unless *key* is in the list
+    std::pair<const Block*, size_t> locate(const K& key) const;
+
+   public:
+    // Forward iterator over the keys in increasing order; dereferences to
+    // a pair of references like SkipList::const_iterator.
+    class const_iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = std::pair<const K&, const V&>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        reference operator*() const { return {block->keys[index], block->values[index]}; }
+
+        const_iterator& operator++() {
+            if (++index == block->keys.size()) {
+                block = block->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous{*this};
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const = default;
+
+       private:
+        friend class SimdSkipList;
+        // Normalizes a position past the end of its block to the start of
+        // the next one, or to end()
+        const_iterator(const Block* block, size_t index) : block{block}, index{index} {
+            while (this->block != nullptr and this->index == this->block->keys.size()) {
+                this->block = this->block->next;
+                this->index = 0;
+            }
+        }
+        const Block* block{nullptr};
+        size_t index{0};
+    };
+
+    SimdSkipList();
+    ~SimdSkipList();
+
+    SimdSkipList(const SimdSkipList&) = delete;
+    SimdSkipList(SimdSkipList&&) = delete;
+    SimdSkipList& operator=(const SimdSkipList&) = delete;
+    SimdSkipList& operator=(SimdSkipList&&) = delete;
+
+    [[nodiscard]] size_t size() const noexcept { return entries; }
+    [[nodiscard]] bool empty() const noexcept { return entries == 0; }
+    [[nodiscard]] size_t layers() const noexcept { return heads.size(); }
+
+    // Same contracts as the SkipList members of the same names, except that
+    // height counts the layers the key is on, sentinel layer excluded.
+    [[nodiscard]] size_t height(const K& key) const;
+    bool insert(const K& key, const V& value);
+    [[nodiscard]] V& find(const K& key);
+    [[nodiscard]] const V& find(const K& key) const;
+    [[nodiscard]] bool contains(const K& key) const;
+    [[nodiscard]] const K& nextKey(const K& key) const;
+    [[nodiscard]] const K& previousKey(const K& key) const;
+    [[nodiscard]] std::vector<K> allKeysInOrder() const;
+    void erase(const K& key);
+
+    [[nodiscard]] const_iterator begin() const { return {heads.front(), 0}; }
+    [[nodiscard]] const_iterator end() const { return {}; }
+    [[nodiscard]] const_iterator lower_bound(const K& key) const {
+        auto [block, index] = lowerBound(key);
+        return {block, index};
+    }
+};
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+SimdSkipList<K, V>::SimdSkipList() {
+    heads.push_back(new Block);
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+SimdSkipList<K, V>::~SimdSkipList() {
+    for (Block* head : heads) {
+        while (head != nullptr) {
+            Block* next{head->next};
+            delete head;
+            head = next;
+        }
+    }
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+size_t SimdSkipList<K, V>::towerHeight(const K& key) noexcept {
+    // splitmix64, so that every bit of the key decides every coin
+    uint64_t hash{static_cast<uint64_t>(key) + 0x9e3779b97f4a7c15ULL};
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return std::min(MAX_LAYERS,
+                    1 + static_cast<size_t>(std::countr_zero(hash)) / FANOUT_BITS);
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+void SimdSkipList<K, V>::addTopLayer() {
+    auto* head = new Block;
+    head->keys.push_back(std::numeric_limits<K>::min());
+    head->children.push_back(heads.back());
+    heads.push_back(head);
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+void SimdSkipList<K, V>::descend(const K& key, Path& path, Positions& positions) const {
+    // On each layer, the block holding the last key less than *key* and
+    // the number of its keys that are less. The block below is the one
+    // that key starts, so the search never moves along a layer.
+    Block* block{heads.back()};
+    for (size_t layer = heads.size() - 1; layer > 0; layer--) {
+        // Only minus infinity can be uncounted, when *key* is the smallest K
+        size_t less{
+            std::max<size_t>(1, countLess(block->keys.data(), block->keys.size(), key))};
+        path[layer] = block;
+        positions[layer] = less;
+        block = block->children[less - 1];
+    }
+    path[0] = block;
+    positions[0] = countLess(block->keys.data(), block->keys.size(), key);
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+std::pair<const typename SimdSkipList<K, V>::Block*, size_t> SimdSkipList<K, V>::lowerBound(
+    const K& key) const {
+    Path path;
+    Positions positions;
+    descend(key, path, positions);
+    return {path[0], positions[0]};
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+std::pair<const typename SimdSkipList<K, V>::Block*, size_t> SimdSkipList<K, V>::locate(
+    const K& key) const {
+    const_iterator found{lower_bound(key)};
+    if (found == end() or not((*found).first == key)) {
+        throw std::out_of_range("Key is not in the SimdSkipList");
+    }
+    return {found.block, found.index};
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+size_t SimdSkipList<K, V>::height(const K& key) const {
+    locate(key);
+    return towerHeight(key);
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+bool SimdSkipList<K, V>::insert(const K& key, const V& value) {
+    if (contains(key)) {
+        return false;
+    }
+    const size_t height{towerHeight(key)};
+    while (heads.size() < height) {
+        addTopLayer();
+    }
+
+    Path path;
+    Positions positions;
+    descend(key, path, positions);
+    Block* below{nullptr};
+    for (size_t layer = 0; layer < height; layer++) {
+        Block* block{path[layer]};
+        auto at = static_cast<std::ptrdiff_t>(positions[layer]);
+        if (layer + 1 == height) {
+            block->keys.insert(block->keys.begin() + at, key);
+            if (layer == 0) {
+                block->values.insert(block->values.begin() + at, value);
+            } else {
+                block->children.insert(block->children.begin() + at, below);
+            }
+            break;
+        }
+
+        // The key goes on up, so here it starts a block of its own that
+        // takes over the keys after it
+        auto* split = new Block;
+        split->keys.reserve(block->keys.size() - positions[layer] + 1);
+        split->keys.push_back(key);
+        split->keys.insert(split->keys.end(), block->keys.begin() + at, block->keys.end());
+        block->keys.erase(block->keys.begin() + at, block->keys.end());
+        if (layer == 0) {
+            split->values.reserve(split->keys.size());
+            split->values.push_back(value);
+            split->values.insert(split->values.end(), block->values.begin() + at,
+                                 block->values.end());
+            block->values.erase(block->values.begin() + at, block->values.end());
+        } else {
+            split->children.reserve(split->keys.size());
+            split->children.push_back(below);
+            split->children.insert(split->children.end(), block->children.begin() + at,
+                                   block->children.end());
+            block->children.erase(block->children.begin() + at, block->children.end());
+        }
+        split->next = block->next;
+        block->next = split;
+        below = split;
+    }
+    entries++;
+    return true;
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+V& SimdSkipList<K, V>::find(const K& key) {
+    auto [block, index] = locate(key);
+    return const_cast<Block*>(block)->values[index];
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+const V& SimdSkipList<K, V>::find(const K& key) const {
+    auto [block, index] = locate(key);
+    return block->values[index];
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+bool SimdSkipList<K, V>::contains(const K& key) const {
+    const_iterator found{lower_bound(key)};
+    return found != end() and (*found).first == key;
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+const K& SimdSkipList<K, V>::nextKey(const K& key) const {
+    auto [block, index] = locate(key);
+    const_iterator next{block, index + 1};
+    if (next == end()) {
+        throw std::out_of_range("Key is the largest in the SimdSkipList");
+    }
+    return (*next).first;
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+const K& SimdSkipList<K, V>::previousKey(const K& key) const {
+    locate(key);
+    // The block the search ends in starts with a key less than *key*,
+    // unless it is the first one
+    auto [block, less] = lowerBound(key);
+    if (less == 0) {
+        throw std::out_of_range("Key is the smallest in the SimdSkipList");
+    }
+    return block->keys[less - 1];
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+std::vector<K> SimdSkipList<K, V>::allKeysInOrder() const {
+    std::vector<K> keys;
+    keys.reserve(entries);
+    for (const Block* block = heads.front(); block != nullptr; block = block->next) {
+        keys.insert(keys.end(), block->keys.begin(), block->keys.end());
+    }
+    return keys;
+}
+
+template <typename K, typename V>
+    requires SimdSearchableKey<K>
+void SimdSkipList<K, V>::erase(const K& key) {
+    locate(key);
+    // The list grew to at least this many layers when the key went in, and
+    // only layers holding no keys are dropped
+    const size_t height{towerHeight(key)};
+
+    Path path;
+    Positions positions;
+    descend(key, path, positions);
+    for (size_t layer = 0; layer < height; layer++) {
+        Block* block{path[layer]};
+        auto at = static_cast<std::ptrdiff_t>(positions[layer]);
+        if (layer + 1 == height) {
+            block->keys.erase(block->keys.begin() + at);
+            if (layer == 0) {
+                block->values.erase(block->values.begin() + at);
+            } else {
+                block->children.erase(block->children.begin() + at);
+            }
+            break;
+        }
+
+        // The key starts the next block here; the rest of it joins this one
+        Block* merged{block->next};
+        block->keys.insert(block->keys.end(), merged->keys.begin() + 1, merged->keys.end());
+        if (layer == 0) {
+            block->values.insert(block->values.end(),
+                                 std::make_move_iterator(merged->values.begin() + 1),
+                                 std::make_move_iterator(merged->values.end()));
+        } else {
+            block->children.insert(block->children.end(), merged->children.begin() + 1,
+                                   merged->children.end());
+        }
+        block->next = merged->next;
+        delete merged;
+    }
+    entries--;
+
+    while (heads.size() > 1 and heads.back()->keys.size() == 1) {
+        delete heads.back();
+        heads.pop_back();
+    }
+}
+
+}  // namespace shindler::ics46::project2
+#endif
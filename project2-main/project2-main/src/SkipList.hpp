@@ -2,12 +2,29 @@
 #define ___SKIP_LIST_HPP
 
 #include <iostream>
-#include <cmath>  // for log2
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "BinaryIO.hpp"
+#include "LatencyHistogram.hpp"
+#include "NodePool.hpp"
+#include "SkipListReport.hpp"
+#include "ValueArena.hpp"
+#include "WorkStealing.hpp"
+
 namespace shindler::ics46::project2 {
 
 /**
@@ -145,36 +162,691 @@ constexpr inline bool flipCoin(const std::string& key, size_t previousFlips) {
     return std::to_integer<uint8_t>(hash & bitToSelect) != 0;
 }
 
-template <typename K, typename V>
+/**
+ * @brief The rule that stops a key from being promoted any further.
+ *
+ * After a key is promoted into a new layer, promotion halts if the skip list
+ * has reached its layer cap: 13 layers while it holds at most 16 keys, and
+ * 3 * ceil(log_2(n)) + 1 layers once it holds n > 16 keys.
+ *
+ * @param size number of keys in the skip list, including the key being
+ * promoted
+ * @param layers current number of layers in the skip list
+ * @return true if the key should not be promoted again
+ */
+constexpr inline bool reachedLayerCap(size_t size, size_t layers) {
+    const size_t SMALL_LIST_SIZE{16};
+    const size_t SMALL_LIST_LAYERS{13};
+
+    if (size <= SMALL_LIST_SIZE) {
+        return layers >= SMALL_LIST_LAYERS;
+    }
+    // bit_width(n - 1) is ceil(log_2(n)) for n > 1. Erases can leave the
+    // list taller than the cap for its new size, hence >= rather than ==.
+    return layers >= 3 * static_cast<size_t>(std::bit_width(size - 1)) + 1;
+}
+
+/**
+ * @brief Work counted by a SkipList whose traits set COUNT_OPERATIONS.
+ *
+ * lookups, inserts and erases count calls; the other counters add up the
+ * work those calls did, so dividing one by the other gives the average
+ * cost per call. Lookups are find, contains and lower_bound.
+ */
+struct SkipListStats {
+    uint64_t lookups{0};
+    uint64_t inserts{0};
+    uint64_t erases{0};
+    // Key comparisons, both < and ==
+    uint64_t comparisons{0};
+    // Steps along a layer and steps down a tower
+    uint64_t nextHops{0};
+    uint64_t downHops{0};
+    // Nodes created and deleted, including the sentinels of new layers
+    uint64_t nodesAllocated{0};
+    uint64_t nodesFreed{0};
+    // Nodes added above the base layer by insert
+    uint64_t promotions{0};
+};
+
+/**
+ * @brief The first eight bytes of *key* as a big-endian integer, padded
+ * with zero bytes.
+ *
+ * If two keys' prefixes differ, comparing the prefixes orders the keys the
+ * same way std::string's operator< does; equal prefixes decide nothing.
+ */
+inline uint64_t stringKeyPrefix(const std::string& key) noexcept {
+    const size_t PREFIX_BYTES{8};
+    uint64_t prefix{0};
+    for (size_t i = 0; i < PREFIX_BYTES; i++) {
+        prefix <<= NUMBER_OF_BITS_IN_BYTE;
+        if (i < key.size()) {
+            prefix |= static_cast<unsigned char>(key[i]);
+        }
+    }
+    return prefix;
+}
+
+/**
+ * @brief Which nodes of a SkipList keep a link to the node before them.
+ *
+ * All is the classic doubly linked list on every layer. BaseOnly keeps the
+ * links on the base layer, which is all previousKey and isLargestKey use,
+ * and stops writing them on every promotion. None drops the link from Node
+ * altogether, and previousKey and isLargestKey search from the top instead.
+ * insert and erase find their neighbours on every layer from the path of
+ * their search, so they work the same way under every policy.
+ */
+enum class BackLinks : uint8_t { All, BaseOnly, None };
+
+/**
+ * @brief Compile-time options for SkipList. Derive from this and override
+ * the members you want to change.
+ */
+struct SkipListTraits {
+    // Keep a SkipListStats, readable through stats(). Off by default, in
+    // which case none of the counting code is compiled in.
+    static constexpr bool COUNT_OPERATIONS{false};
+    // Time every find, contains, insert, erase and range scan into
+    // per-thread latency histograms, readable through latencyHistogram().
+    // Off by default, in which case no clock is read.
+    static constexpr bool RECORD_LATENCY{false};
+    // Which nodes link back to their predecessor; see BackLinks
+    static constexpr BackLinks BACK_LINKS{BackLinks::All};
+    // With std::string keys, cache each key's stringKeyPrefix in its index
+    // nodes so that searches compare the cached prefixes first. It costs 8
+    // bytes per index node, about 5% of a string/string list. On the
+    // benchmark's text keys, which differ within their first bytes, finds
+    // and inserts at 10,000 and 100,000 keys took 20 to 40% less time; on
+    // keys sharing an eight byte prefix the prefixes always tie and the
+    // timings were within noise of leaving it off.
+    static constexpr bool ABBREVIATE_KEYS{true};
+    // Values up to this size live inside their base node; larger ones live
+    // in a ValueArena and the node holds a pointer to them
+    static constexpr size_t INLINE_VALUE_BYTES{64};
+    // Keep a V in every base node. Only for an empty V whose objects are
+    // interchangeable may this be false, as SkipSet's traits set it: base
+    // nodes then hold no value and every key shares one V.
+    static constexpr bool STORE_VALUES{true};
+};
+
+/**
+ * @brief SkipListTraits with operation counting turned on.
+ */
+struct CountingSkipListTraits : SkipListTraits {
+    static constexpr bool COUNT_OPERATIONS{true};
+};
+
+/**
+ * @brief SkipListTraits with latency recording turned on.
+ */
+struct LatencySkipListTraits : SkipListTraits {
+    static constexpr bool RECORD_LATENCY{true};
+};
+
+template <typename K, typename V, typename Traits = SkipListTraits>
 class SkipList {
    private:
    size_t SkipListSize{0};
    size_t SkipListLayers{0};
+
+   // Empty unless Traits::COUNT_OPERATIONS is set. Lookups are const, so
+   // it is mutable; that also means a counting list must not be searched
+   // from several threads at once.
+   struct NoStats {};
+   [[no_unique_address]] mutable
+       std::conditional_t<Traits::COUNT_OPERATIONS, SkipListStats, NoStats> statistics;
+
+   void count(uint64_t SkipListStats::*counter, uint64_t amount = 1) const
+   {
+    if constexpr (Traits::COUNT_OPERATIONS)
+    {
+        statistics.*counter += amount;
+    }
+   }
+
+   // Empty unless Traits::RECORD_LATENCY is set
+   struct NoLatency {};
+   [[no_unique_address]] mutable
+       std::conditional_t<Traits::RECORD_LATENCY, LatencyRecorder, NoLatency> latency;
+
+   // Keep the result alive for the scope being timed
+   auto timeOperation(LatencyOperation operation) const
+   {
+    if constexpr (Traits::RECORD_LATENCY)
+    {
+        return ScopedLatency{latency, operation};
+    }
+    else
+    {
+        return NoLatency{};
+    }
+   }
+
+   bool keyLess(const K& lhs, const K& rhs) const
+   {
+    count(&SkipListStats::comparisons);
+    return lhs < rhs;
+   }
+
+   bool keyEqual(const K& lhs, const K& rhs) const
+   {
+    count(&SkipListStats::comparisons);
+    return lhs == rhs;
+   }
+   // Stands in for Node::previous when Traits::BACK_LINKS is None
+   struct NoLink {};
+
+   // Searches compare an index node's cached key prefix with the searched
+   // key's before the keys themselves, so most steps above the base layer
+   // never read a long string's heap buffer; only prefixes that tie fall
+   // through to the full compare. Base layer nodes carry no prefix.
+   static constexpr bool ABBREVIATED{Traits::ABBREVIATE_KEYS and std::is_same_v<K, std::string>};
+   struct NoPrefix {};
+   using Prefix = std::conditional_t<ABBREVIATED, uint64_t, NoPrefix>;
+
+   static Prefix abbreviate([[maybe_unused]] const K& key)
+   {
+    if constexpr (ABBREVIATED)
+    {
+        return stringKeyPrefix(key);
+    }
+    else
+    {
+        return {};
+    }
+   }
+
+   // The key is a union member so that sentinels, which have none, never
+   // construct a K. destroyNode and destroySentinel know which is which.
    struct Node
    {
-    Node(K k, V v)
-    :key{k}, value{v}, next{nullptr}, up{nullptr}, down{nullptr}, previous{nullptr}
+    Node()
+    :next{nullptr}, up{nullptr}, down{nullptr}
+    {
+    }
+
+    explicit Node(K k)
+    :next{nullptr}, up{nullptr}, down{nullptr}, key{std::move(k)}
+    {
+    }
+
+    ~Node()
     {
     }
-    K key;
-    V value;
+
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+
+    // Links first: a small key then sits in what would be tail padding,
+    // and a BaseNode's value can reuse the padding after it
     Node * next{nullptr};
     Node * up{nullptr};
     Node * down{nullptr};
-    Node * previous{nullptr};
+    [[no_unique_address]]
+        std::conditional_t<Traits::BACK_LINKS == BackLinks::None, NoLink, Node *> previous{};
+    union
+    {
+        K key;
+    };
+   };
+
+   // A key node above the base layer, with the key's prefix when keys are
+   // abbreviated. Sentinels above the base layer are plain Nodes.
+   struct PrefixedNode : Node
+   {
+    explicit PrefixedNode(K k)
+    :Node{std::move(k)}, prefix{abbreviate(this -> key)}
+    {
+    }
+
+    Prefix prefix;
+   };
+
+   using IndexNode = std::conditional_t<ABBREVIATED, PrefixedNode, Node>;
+
+   // Every node on the base layer, sentinels included, is a BaseNode, and
+   // only those hold a value: the index nodes above a key hold the key
+   // alone, so each value is stored (and copied) once. Values larger than
+   // Traits::INLINE_VALUE_BYTES are kept in valueArena instead, so that a
+   // big V does not spread the nodes a search walks over more cache lines.
+   // Without Traits::STORE_VALUES, as in a SkipSet, V is not stored at all:
+   // base layer nodes are then plain Nodes and valueOf hands out one
+   // shared V.
+   static constexpr bool INLINE_VALUES{sizeof(V) <= Traits::INLINE_VALUE_BYTES};
+   static constexpr bool VALUELESS{not Traits::STORE_VALUES};
+   static_assert(Traits::STORE_VALUES or std::is_empty_v<V>,
+                 "Only an empty V can go unstored");
+   using ValueSlot = std::conditional_t<INLINE_VALUES, V, V *>;
+
+   struct ValueNode : Node
+   {
+    ValueNode()
+    {
+    }
+
+    ValueNode(K k, ValueSlot v)
+    :Node{std::move(k)}, value{std::move(v)}
+    {
+    }
+
+    ~ValueNode()
+    {
+    }
+
+    union
+    {
+        ValueSlot value;
+    };
    };
+
+   using BaseNode = std::conditional_t<VALUELESS, Node, ValueNode>;
+
+   struct NoArena {};
+   using Arena = std::conditional_t<INLINE_VALUES, NoArena, ValueArena<V>>;
+   [[no_unique_address]] Arena valueArena;
+
+   // Every key node lives in one of these, so teardown frees chunks rather
+   // than nodes. The sentinels of upper layers have a pool of their own,
+   // so that clear() can free every slot of the others at once and keep
+   // them; the base layer's two come from plain new.
+   NodePool<BaseNode> baseNodePool;
+   NodePool<IndexNode> indexNodePool;
+   NodePool<Node> sentinelPool;
+   // Inserts that leave at most this many keys take every node from the
+   // pools; see reserve()
+   size_t reservedKeys{0};
+
+   // Nothing to do for a node's key or value when it goes
+   static constexpr bool TRIVIAL_CONTENTS{std::is_trivially_destructible_v<K> and
+                                          std::is_trivially_destructible_v<V>};
+
+   // Bulk builds make nodes from several threads at once, each into a pool
+   // and an arena of its own
+   Node * newBaseNode(const K& key, [[maybe_unused]] const V& value, NodePool<BaseNode>& pool,
+                      [[maybe_unused]] Arena& arena)
+   {
+    if constexpr (VALUELESS)
+    {
+        return pool.create(key);
+    }
+    else if constexpr (INLINE_VALUES)
+    {
+        return pool.create(key, value);
+    }
+    else
+    {
+        V * stored{arena.create(value)};
+        try
+        {
+            return pool.create(key, stored);
+        }
+        catch (...)
+        {
+            arena.destroy(stored);
+            throw;
+        }
+    }
+   }
+
+   // Is the key of *node*, a key node on *layer*, less than *key*, whose
+   // prefix is *prefix*?
+   bool nodeLess(const Node * node, [[maybe_unused]] size_t layer, const K& key,
+                 [[maybe_unused]] Prefix prefix) const
+   {
+    if constexpr (ABBREVIATED)
+    {
+        if (layer > 0)
+        {
+            const auto * indexNode = static_cast<const IndexNode *>(node);
+            if (indexNode -> prefix != prefix)
+            {
+                count(&SkipListStats::comparisons);
+                return indexNode -> prefix < prefix;
+            }
+        }
+    }
+    return keyLess(node -> key, key);
+   }
+
+   static V& valueOf([[maybe_unused]] Node * node)
+   {
+    if constexpr (VALUELESS)
+    {
+        static V none{};
+        return none;
+    }
+    else if constexpr (INLINE_VALUES)
+    {
+        return static_cast<BaseNode *>(node) -> value;
+    }
+    else
+    {
+        return *static_cast<BaseNode *>(node) -> value;
+    }
+   }
+
+   static const V& valueOf([[maybe_unused]] const Node * node)
+   {
+    if constexpr (VALUELESS)
+    {
+        static V none{};
+        return none;
+    }
+    else if constexpr (INLINE_VALUES)
+    {
+        return static_cast<const BaseNode *>(node) -> value;
+    }
+    else
+    {
+        return *static_cast<const BaseNode *>(node) -> value;
+    }
+   }
+
+   // Destroy the key of a node, and its value if it is on the base layer,
+   // which is the layer with nothing below it. The node's slot is left
+   // alone, and so is an out of line value's unless *freeValue*.
+   void destroyContents(Node * node, bool freeValue = true)
+   {
+    destroyContents(node, freeValue ? &valueArena : nullptr);
+   }
+
+   // The same, giving an out of line value's slot back to *arena* unless
+   // that is null
+   static void destroyContents(Node * node, [[maybe_unused]] Arena * arena)
+   {
+    std::destroy_at(&node -> key);
+    if (node -> down == nullptr)
+    {
+        auto * base = static_cast<BaseNode *>(node);
+        if constexpr (VALUELESS)
+        {
+            // Nothing stored
+        }
+        else if constexpr (INLINE_VALUES)
+        {
+            std::destroy_at(&base -> value);
+        }
+        else if (arena != nullptr)
+        {
+            arena -> destroy(base -> value);
+        }
+        else
+        {
+            std::destroy_at(base -> value);
+        }
+    }
+   }
+
+   // Free a node that holds a key
+   void destroyNode(Node * node)
+   {
+    destroyContents(node);
+    if (node -> down == nullptr)
+    {
+        baseNodePool.destroy(static_cast<BaseNode *>(node));
+    }
+    else
+    {
+        indexNodePool.destroy(static_cast<IndexNode *>(node));
+    }
+   }
+
+   // Free a sentinel, which holds no key or value
+   void destroySentinel(Node * node)
+   {
+    if (node -> down == nullptr)
+    {
+        delete static_cast<BaseNode *>(node);
+    }
+    else
+    {
+        sentinelPool.destroy(node);
+    }
+   }
+
+   // Link node back to previousNode, if Traits::BACK_LINKS keeps links on
+   // *layer*
+   static void setPrevious([[maybe_unused]] Node * node, [[maybe_unused]] Node * previousNode,
+                           [[maybe_unused]] size_t layer)
+   {
+    if constexpr (Traits::BACK_LINKS == BackLinks::All)
+    {
+        node -> previous = previousNode;
+    }
+    else if constexpr (Traits::BACK_LINKS == BackLinks::BaseOnly)
+    {
+        if (layer == 0)
+        {
+            node -> previous = previousNode;
+        }
+    }
+   }
    Node * front{};
    Node * back{};
    Node * topFront{};
    Node * topBack{};
 
+   // The first and last node linked on every layer of a run of towers that
+   // is built off to the side (a bulk build thread's slice, or a snapshot
+   // being loaded) and linked in afterwards. Layers it never reached hold
+   // nullptr.
+   struct Segment
+   {
+    explicit Segment(size_t layers)
+    :firsts(layers, nullptr), lasts(layers, nullptr)
+    {
+    }
+
+    std::vector<Node *> firsts;
+    std::vector<Node *> lasts;
+    // Where this segment's nodes live until it is linked in
+    NodePool<BaseNode> baseNodes;
+    NodePool<IndexNode> indexNodes;
+    [[no_unique_address]] Arena values;
+   };
+
     // private variables go here.
 
+   // Snapshot files are a header, blocks of up to SNAPSHOT_BLOCK_SIZE
+   // entries (count, keys, values, then heights if saved) and a checksum.
+   static constexpr uint64_t SNAPSHOT_MAGIC{0x3150414e534b5350ULL}; // "PSKSNAP1"
+   static constexpr uint32_t SNAPSHOT_VERSION{1};
+   static constexpr uint32_t SNAPSHOT_WITH_HEIGHTS{1};
+   static constexpr size_t SNAPSHOT_BLOCK_SIZE{4096};
+
+   // load rejects snapshots with more layers, and the layer cap stops
+   // insert long before it, so a search path always fits in a PathArray
+   static constexpr size_t MAX_LAYERS{UINT8_MAX};
+   using PathArray = std::array<Node *, MAX_LAYERS>;
+
+    void addTopLayer();
+    size_t towerHeight(const K& key, size_t size, size_t& layers) const;
+    void appendTower(const K& key, const V& value, size_t height, Segment& segment);
+    void buildSegment(const std::vector<std::pair<K, V>>& entries,
+                             const std::vector<uint8_t>& heights,
+                             size_t begin, size_t end, Segment& segment);
+    void destroySegment(Segment& segment);
+    void linkSegments(std::vector<Segment>& segments, size_t layers, size_t size);
+    Node* lowerBoundOnLayer(const K& key, size_t layer) const;
+    Node* searchPath(const K& key, PathArray& path) const;
+    Node* linkNewTower(const K& key, const V& value, Node* tmp, PathArray& path);
+    std::vector<Node *> scanChunks(const K& lo, const K& hi, size_t chunks) const;
+
+   public:
+    // Forward iterator over the keys in increasing order. Dereferencing it
+    // gives the key and value as a pair of references, so it works with
+    // structured bindings: for (auto [key, value] : skipList).
+    class const_iterator
+    {
+       public:
+        // Dereferencing makes a pair rather than returning a reference, which
+        // a Cpp17ForwardIterator must do, so only the C++20 concept is forward
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = std::pair<const K&, const V&>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            return {node -> key, valueOf(node)};
+        }
+
+        // Height of the current key, like SkipList::height but without the
+        // search.
+        [[nodiscard]] size_t height() const
+        {
+            size_t layers{1};
+            for (const Node * tmp = node -> up; tmp != nullptr; tmp = tmp -> up)
+            {
+                layers++;
+            }
+            return layers;
+        }
+
+        const_iterator& operator++()
+        {
+            node = node -> next;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator previous{*this};
+            node = node -> next;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const = default;
+
+       private:
+        friend class SkipList;
+        explicit const_iterator(const Node * node) : node{node} {}
+        const Node * node{nullptr};
+    };
+
+    // A key's whole tower, taken out of a skip list by extract and owned
+    // here until insert links it into this or another skip list, or the
+    // handle is destroyed. The key may be changed in the meantime; the
+    // tower keeps its height either way. The nodes, and a value stored out
+    // of line, stay where they are: the handle shares the chunks they sit
+    // in, so it may outlive the list it came from. Inserting it into
+    // another list passes those shares on, so each whole chunk, up to
+    // 4 KiB of the source's slots, stays allocated for as long as the
+    // receiving list holds it (until it is cleared or destroyed), even
+    // after the source is gone. Moving a few keys out of a big list that is
+    // then destroyed can keep much of its storage alive; copying the entry
+    // with insert(key, value) does not.
+    class node_type
+    {
+       public:
+        node_type() = default;
+
+        node_type(node_type&& other) noexcept
+        :tower{std::exchange(other.tower, nullptr)}, baseNodes{std::move(other.baseNodes)},
+        indexNodes{std::move(other.indexNodes)}, values{std::move(other.values)}
+        {
+        }
+
+        node_type& operator=(node_type&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                tower = std::exchange(other.tower, nullptr);
+                baseNodes = std::move(other.baseNodes);
+                indexNodes = std::move(other.indexNodes);
+                values = std::move(other.values);
+            }
+            return *this;
+        }
+
+        ~node_type()
+        {
+            release();
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return tower == nullptr;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return tower != nullptr;
+        }
+
+        // Only for a handle that is not empty
+        [[nodiscard]] K& key() const
+        {
+            return tower -> key;
+        }
+
+        [[nodiscard]] V& mapped() const
+        {
+            return valueOf(tower);
+        }
+
+       private:
+        friend class SkipList;
+        void release() noexcept
+        {
+            while (tower != nullptr)
+            {
+                Node * above{tower -> up};
+                destroyContents(tower, &values);
+                if (tower -> down == nullptr)
+                {
+                    baseNodes.destroy(static_cast<BaseNode *>(tower));
+                }
+                else
+                {
+                    indexNodes.destroy(static_cast<IndexNode *>(tower));
+                }
+                tower = above;
+            }
+        }
+
+        // The base node; the rest of the tower is above it
+        Node * tower{nullptr};
+        // Shares of the chunks holding the tower and its value
+        NodePool<BaseNode> baseNodes;
+        NodePool<IndexNode> indexNodes;
+        [[no_unique_address]] Arena values;
+    };
+
+    // What insert(node_type&&) did: where the key is, whether the handle's
+    // tower was linked in, and the handle back if it was not.
+    struct insert_return_type
+    {
+        const_iterator position;
+        bool inserted;
+        node_type node;
+    };
+
+   private:
+    // Share the chunks holding *tower* and its out of line value from the
+    // first pools and arena into the second, which then free them
+    static void moveTower(Node * tower, NodePool<BaseNode>& fromBase,
+                          NodePool<IndexNode>& fromIndex, Arena& fromValues,
+                          NodePool<BaseNode>& toBase, NodePool<IndexNode>& toIndex,
+                          Arena& toValues);
+
    public:
+
     SkipList();
 
     void printSkipList() const;
 
+    // Describe the shape of the skip list: nodes per layer, the height
+    // histogram against a fair coin's, search path lengths and memory use.
+    // One pass over the nodes, no output. See SkipListReport.
+    [[nodiscard]] SkipListReport structureReport() const;
+
     Node* findNode(const K& key);
     Node* findNode(const K& key) const;
 
@@ -238,9 +910,109 @@ class SkipList {
     // not insert one -- return false.
     bool insert(const K& key, const V& value);
 
+    // Return an iterator to this key and whether it was inserted, inserting
+    // it with *value* first if it is not here yet. Unlike contains or find
+    // followed by insert, this searches once.
+    std::pair<const_iterator, bool> findOrInsert(const K& key, const V& value);
+
+    // The value at *position*, which must not be end(), for changing it
+    // without searching for its key again
+    [[nodiscard]] V& mapped(const_iterator position);
+
+    // Link the tower held by *node* in under its key, without allocating
+    // or copying a key node. If the key is already here (or *node* is
+    // empty) nothing changes and the handle is returned in the result. A
+    // tower taller than the skip list adds layers, like any insert. A tower
+    // from another list keeps its chunks allocated here; see node_type.
+    insert_return_type insert(node_type&& node);
+
+    // Unlink the tower of this key and hand it over, or return an empty
+    // handle if there is no such key. Nothing is freed or copied; the
+    // handle only takes a share of the chunks the tower sits in.
+    [[nodiscard]] node_type extract(const K& key);
+
+    // Set aside storage for *expectedKeys* keys in all: a base node and,
+    // for values kept out of line, an arena slot for each new key, the
+    // sentinels of every layer the list may grow to by then, and index
+    // nodes for the average of one per key plus a quarter and 64 more.
+    // Inserts up to that size never call the global allocator for nodes or
+    // values. A tower may reach the layer cap, and setting that much aside
+    // for every key would cost many times the list itself, so instead an
+    // insert whose tower finds the reserved index nodes used up stops it
+    // there. Only keys whose coin flips (taken from the key's bits) run
+    // well above average get shorter towers than they otherwise would.
+    void reserve(size_t expectedKeys);
+
+    // Return node and value storage that nothing is using, whether it was
+    // reserved or left behind by erase and clear. Towers grow freely again
+    // afterwards.
+    void shrinkToFit();
+
+    // Nodes that can be made, and out of line values stored, before the
+    // list allocates more storage. Inline values need no storage of their
+    // own, so there are never any of the latter for them.
+    [[nodiscard]] size_t reservedNodes() const noexcept;
+    [[nodiscard]] size_t reservedValues() const noexcept;
+
+    // Bytes of node and value storage this list holds, in use or not,
+    // counting chunks shared with node handles and other lists in full
+    [[nodiscard]] size_t storageBytes() const noexcept;
+
+    // Fill an empty skip list from entries sorted by strictly increasing key,
+    // splitting the work across *threads* threads (0 picks one per core).
+    // The result is identical to inserting the entries one at a time in
+    // order: same heights, same layers. Throw a std::logic_error if the
+    // skip list is not empty and a std::invalid_argument if the keys are not
+    // strictly increasing.
+    void buildFromSorted(const std::vector<std::pair<K, V>>& entries,
+                         size_t threads = 0);
+
     // Return a vector containing all inserted keys in increasing order.
     [[nodiscard]] std::vector<K> allKeysInOrder() const;
 
+    // Is this key in the Skip List? Unlike find, this never throws.
+    [[nodiscard]] bool contains(const K& key) const;
+
+    // Iterators over the keys in increasing order.
+    [[nodiscard]] const_iterator begin() const;
+    [[nodiscard]] const_iterator end() const;
+
+    // Return an iterator to the smallest key that is not less than *key*,
+    // or end() if there is none.
+    [[nodiscard]] const_iterator lower_bound(const K& key) const;
+
+    // Write every key and value to a binary snapshot at *path*, along with
+    // the height of every key if *withHeights* is set. Trivially copyable
+    // keys and values are written as raw arrays and strings as a length
+    // followed by their characters. Throw a std::runtime_error if the file
+    // cannot be written.
+    void save(const std::string& path, bool withHeights = true) const;
+
+    // Fill an empty skip list from a snapshot written by save, in one pass
+    // over the file. Saved heights are used as they are; without them the
+    // list is rebuilt as if the keys were inserted in order. Throw a
+    // std::logic_error if the skip list is not empty and a
+    // std::runtime_error if the file cannot be read, is truncated, or fails
+    // its checksum; the skip list stays empty in both cases.
+    void load(const std::string& path);
+
+    // Call fn(key, value) once for every key in [lo, hi), using up to
+    // *threads* threads (0 picks one per core). The range is cut into chunks
+    // at the nodes of an upper layer, so the calls for different chunks run
+    // concurrently and in no particular order; fn must be safe to call
+    // from several threads at once. The skip list must not be modified
+    // while the scan runs.
+    template <typename F>
+    void parallelForEach(const K& lo, const K& hi, F fn, size_t threads = 0) const;
+
+    // Fold every key in [lo, hi) into one result: each chunk starts from
+    // *identity* and folds in map(key, value) with combine, and the chunk
+    // results are then combined in key order. combine must be associative
+    // and *identity* must be its identity element.
+    template <typename T, typename Map, typename Combine>
+    [[nodiscard]] T parallelReduce(const K& lo, const K& hi, T identity, Map map,
+                                   Combine combine, size_t threads = 0) const;
+
     // Is this the smallest key in the SkipList? Throw a std::out_of_range
     // if the key *k* does not exist in the Skip List.
     [[nodiscard]] bool isSmallestKey(const K& key) const;
@@ -252,29 +1024,51 @@ class SkipList {
     // Erase the given key from the skip list. Throw a std::out_of_range
     // if the key *key* does not exist in the SkipList
     void erase(const K& key);
+
+    // Erase every key, keeping the layers and their sentinels. The nodes'
+    // storage is kept for later inserts (shrinkToFit() gives it back), and
+    // keys and values with trivial destructors are not visited at all.
+    void clear();
+
+    // The work counted since construction or the last resetStats(). Only
+    // available when Traits::COUNT_OPERATIONS is set.
+    [[nodiscard]] const SkipListStats& stats() const noexcept
+        requires Traits::COUNT_OPERATIONS;
+    void resetStats() noexcept
+        requires Traits::COUNT_OPERATIONS;
+
+    // Latencies recorded by every thread for *operation*, merged into one
+    // histogram, and the same for every operation as percentile lines. Only
+    // available when Traits::RECORD_LATENCY is set.
+    [[nodiscard]] LatencyHistogram latencyHistogram(LatencyOperation operation) const
+        requires Traits::RECORD_LATENCY;
+    void writeLatencyPercentiles(std::ostream& out) const
+        requires Traits::RECORD_LATENCY;
+    void resetLatency()
+        requires Traits::RECORD_LATENCY;
 };
 
-template <typename K, typename V>
-SkipList<K, V>::SkipList() 
+template <typename K, typename V, typename Traits>
+SkipList<K, V, Traits>::SkipList() 
 {
     //Intialize the intial two layer lists.
     
-    this -> front = new Node({}, {});
-    this -> back = new Node({}, {});
-    this -> topFront = new Node({}, {});
-    this -> topBack = new Node({}, {});
+    this -> front = new BaseNode();
+    this -> back = new BaseNode();
+    this -> topFront = sentinelPool.create();
+    this -> topBack = sentinelPool.create();
 
     //Sets front's next and up nodes should have nullptr for down and previous
     this -> front -> up = this -> topFront;
     this -> front -> next = this -> back;
     //Sets back's previous and up nodes should have nullptr for next and down
-    this -> back -> previous = this -> front;
+    setPrevious(this -> back, this -> front, 0);
     this -> back -> up = this -> topBack;
     //Sets topFront's down and next nodes, should have nullptr for previous and up
     this -> topFront -> down = this -> front;
     this -> topFront -> next = this -> topBack;
     //Sets topBack's previous and down nodes, should have nulltr up and next.
-    this -> topBack -> previous = this -> topFront;
+    setPrevious(this -> topBack, this -> topFront, 1);
     this -> topBack -> down = this -> back;
     //Initialize SkipListLayers to deflaut value of 2
     SkipListLayers += 2;
@@ -282,15 +1076,21 @@ SkipList<K, V>::SkipList()
     
 }
 
-template <typename K, typename V>
-void SkipList<K, V>::printSkipList() const {
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::printSkipList() const {
     Node* current = topFront;
 
     while (current != nullptr) {
         Node* tmp = current;
 
         while (tmp != nullptr) {
-            std::cout << tmp->key << " ";
+            if (tmp == current) {
+                std::cout << "-inf ";
+            } else if (tmp->next == nullptr) {
+                std::cout << "inf ";
+            } else {
+                std::cout << tmp->key << " ";
+            }
             tmp = tmp->next;
         }
 
@@ -301,45 +1101,172 @@ void SkipList<K, V>::printSkipList() const {
 }
 
 
-template <typename K, typename V>
-SkipList<K, V>::~SkipList() {
+template <typename K, typename V, typename Traits>
+SkipListReport SkipList<K, V, Traits>::structureReport() const
+{
+    SkipListReport report;
+    report.size = SkipListSize;
+    report.layers = SkipListLayers;
+    report.nodesPerLayer.assign(SkipListLayers, 0);
+    report.nodeCount = 2 * SkipListLayers; //Two sentinels per layer
+
+    //A search for a key walks, on each layer, from the node it dropped down
+    //onto to the last node before the key. rank counts the key nodes passed
+    //so far on each layer and entryRank is the rank of the node a search
+    //drops onto, so the walk on a layer is rank - entryRank steps and
+    //stepsSoFar is their sum over every layer.
+    std::vector<size_t> rank(SkipListLayers, 0);
+    std::vector<size_t> entryRank(SkipListLayers, 0);
+    size_t stepsSoFar{0};
+    size_t totalPath{0};
+
+    for (Node * base = this -> front -> next; base != this -> back; base = base -> next)
+    {
+        size_t path{stepsSoFar + SkipListLayers - 1};
+        totalPath += path;
+        report.maxSearchPath = std::max(report.maxSearchPath, path);
+
+        report.valueHeapBytes += heapBytes(valueOf(base)) + (INLINE_VALUES ? 0 : sizeof(V));
+        size_t height{0};
+        for (Node * tmp = base; tmp != nullptr; tmp = tmp -> up)
+        {
+            report.nodesPerLayer[height]++;
+            report.keyHeapBytes += heapBytes(tmp -> key);
+            height++;
+        }
+        report.nodeCount += height;
+        if (report.heightHistogram.size() < height)
+        {
+            report.heightHistogram.resize(height, 0);
+        }
+        report.heightHistogram[height - 1]++;
+
+        //Later searches drop straight onto this tower below its top layer
+        //and walk one node further on its top layer
+        for (size_t layer = 0; layer + 1 < height; layer++)
+        {
+            stepsSoFar -= rank[layer] - entryRank[layer];
+            rank[layer]++;
+            entryRank[layer] = rank[layer];
+        }
+        rank[height - 1]++;
+        stepsSoFar++;
+    }
+
+    for (size_t nodes : report.nodesPerLayer)
+    {
+        if (nodes == 0)
+        {
+            report.emptyLayers++;
+        }
+    }
+
+    //A fair coin gives height h with probability 2^-h
+    double expectedShare{0.5};
+    double deviation{0};
+    for (size_t keys : report.heightHistogram)
+    {
+        report.expectedHeightHistogram.push_back(expectedShare * static_cast<double>(SkipListSize));
+        deviation += std::abs(static_cast<double>(keys) / static_cast<double>(SkipListSize) - expectedShare);
+        expectedShare /= 2;
+    }
+    if (SkipListSize > 0)
+    {
+        //Heights above the tallest tower were expected with probability
+        //2 * expectedShare in total but never happened
+        report.heightDeviation = (deviation + 2 * expectedShare) / 2;
+        report.averageSearchPath = static_cast<double>(totalPath) / static_cast<double>(SkipListSize);
+    }
+
+    //Keys and the two sentinels have a BaseNode on the base layer, and the
+    //sentinels above it are plain Nodes
+    const size_t baseNodes{SkipListSize + 2};
+    const size_t upperSentinels{2 * (SkipListLayers - 1)};
+    report.nodeBytes = baseNodes * sizeof(BaseNode) + upperSentinels * sizeof(Node)
+                     + (report.nodeCount - baseNodes - upperSentinels) * sizeof(IndexNode);
+    return report;
+}
+
+template <typename K, typename V, typename Traits>
+SkipList<K, V, Traits>::~SkipList() {
+    // Key nodes go with their pools' chunks, all at once, so a layer is
+    // only walked if its keys or values have destructors to run. Out of
+    // line values go with the arena the same way.
     Node* current = topFront;
+    Node* currentBack = topBack;
     
     while (current != nullptr) {
         Node* nextLayer = current->down;
-        Node* temp;
+        Node* nextLayerBack = currentBack->down;
         
-        // Delete all nodes in the current layer
-        while (current != nullptr) {
-            temp = current;
-            current = current->next;
-            delete temp;
+        bool holdsSomething{nextLayer == nullptr ? not TRIVIAL_CONTENTS
+                                                 : not std::is_trivially_destructible_v<K>};
+        if (holdsSomething) {
+            for (Node* temp = current->next; temp != currentBack; temp = temp->next) {
+                destroyContents(temp, false);
+            }
         }
+        destroySentinel(current);
+        destroySentinel(currentBack);
         
         current = nextLayer;
+        currentBack = nextLayerBack;
     }
     
     // Reset pointers after all nodes are deleted
     front = back = topFront = topBack = nullptr;
 }
 
-template <typename K, typename V>
-size_t SkipList<K, V>::size() const noexcept {
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::clear()
+{
+    Node * layerFront{this -> front};
+    Node * layerBack{this -> back};
+    for (size_t layer = 0; layerFront != nullptr; layer++)
+    {
+        //Out of line values still give their arena slots back one at a time
+        bool holdsSomething{layer == 0 ? not TRIVIAL_CONTENTS or not INLINE_VALUES
+                                       : not std::is_trivially_destructible_v<K>};
+        if (holdsSomething)
+        {
+            Node * tmp{layerFront -> next};
+            while (tmp != layerBack)
+            {
+                Node * next{tmp -> next};
+                destroyContents(tmp);
+                tmp = next;
+            }
+        }
+        layerFront -> next = layerBack;
+        setPrevious(layerBack, layerFront, layer);
+
+        layerFront = layerFront -> up;
+        layerBack = layerBack -> up;
+    }
+    //Every slot is free once the keys are gone, so they are freed all at
+    //once. Chunks a node handle or another list shares are let go instead.
+    baseNodePool.reset();
+    indexNodePool.reset();
+    SkipListSize = 0;
+}
+
+template <typename K, typename V, typename Traits>
+size_t SkipList<K, V, Traits>::size() const noexcept {
     return SkipListSize;
 }
 
-template <typename K, typename V>
-bool SkipList<K, V>::empty() const noexcept {
+template <typename K, typename V, typename Traits>
+bool SkipList<K, V, Traits>::empty() const noexcept {
     return (SkipListSize == 0);
 }
 
-template <typename K, typename V>
-size_t SkipList<K, V>::layers() const noexcept {
+template <typename K, typename V, typename Traits>
+size_t SkipList<K, V, Traits>::layers() const noexcept {
     return SkipListLayers;
 }
 
-template <typename K, typename V>
-size_t SkipList<K, V>::height(const K& key) const {
+template <typename K, typename V, typename Traits>
+size_t SkipList<K, V, Traits>::height(const K& key) const {
     size_t layers{1};
     Node * tmp = findNode(key);
     while (tmp -> up != nullptr)
@@ -350,8 +1277,8 @@ size_t SkipList<K, V>::height(const K& key) const {
     return layers;
 }
 
-template <typename K, typename V>
-const K& SkipList<K, V>::nextKey(const K& key) const {
+template <typename K, typename V, typename Traits>
+const K& SkipList<K, V, Traits>::nextKey(const K& key) const {
     // TODO - your implementation goes here!
     Node * tmp{findNode(key)};
     if (tmp -> next -> next == nullptr)
@@ -361,108 +1288,116 @@ const K& SkipList<K, V>::nextKey(const K& key) const {
     return tmp -> next -> key;
 }
 
-template <typename K, typename V>
-const K& SkipList<K, V>::previousKey(const K& key) const {
-    Node * tmp{findNode(key)};
-    if (tmp -> previous -> previous == nullptr)
-    {
-        throw std::runtime_error("ERROR");
-    }
-    return tmp -> previous -> key;
-}
-
-template <typename K, typename V>
-typename SkipList<K, V>::Node* SkipList<K, V>::findNode(const K& key){
-    Node * tmp{this -> topFront}; // We will start the skip list finding feature from the top
-    while (tmp -> down != nullptr) // Go until tmp -> down is a nullptr which means that it is at the base layer and cannot go anymore
+template <typename K, typename V, typename Traits>
+const K& SkipList<K, V, Traits>::previousKey(const K& key) const {
+    if constexpr (Traits::BACK_LINKS == BackLinks::None)
     {
-        if (tmp -> next -> next != nullptr and tmp -> next -> key < key) //Tmp -> next -> next is used to find the tail since the tail will be the only one with a next nullptr
+        //Without back links the key before is the last one the search
+        //passes on the base layer
+        PathArray path;
+        Node * before{searchPath(key, path)};
+        if (before -> next == this -> back or not keyEqual(before -> next -> key, key))
         {
-            tmp = tmp -> next;
+            throw std::out_of_range("Error");
         }
-        else
+        if (before == this -> front)
         {
-            tmp = tmp -> down; //If tmp cannot find a value that matches the criteria then tmp will just go down
+            throw std::runtime_error("ERROR");
         }
+        return before -> key;
     }
-    while (tmp -> next -> next != nullptr) // Will keep going until the next value is back or next value's key is greater than the key
+    else
     {
-        tmp = tmp -> next;
-        if (tmp -> key == key)
-        {   
-            return tmp;
+        Node * tmp{findNode(key)};
+        if (tmp -> previous -> previous == nullptr)
+        {
+            throw std::runtime_error("ERROR");
         }
+        return tmp -> previous -> key;
     }
-    throw std::out_of_range("Error");
 }
 
-template <typename K, typename V>
-typename SkipList<K, V>::Node* SkipList<K, V>::findNode(const K& key) const{
-    Node * tmp{this -> topFront}; // We will start the skip list finding feature from the top
-    while (tmp -> down != nullptr) // Go until tmp -> down is a nullptr which means that it is at the base layer and cannot go anymore
-    {
-        if (tmp -> next -> next != nullptr and tmp -> next -> key < key) //Tmp -> next -> next is used to find the tail since the tail will be the only one with a next nullptr
-        {
-            tmp = tmp -> next;
-        }
-        else
-        {
-            tmp = tmp -> down; //If tmp cannot find a value that matches the criteria then tmp will just go down
-        }
-    }
-    while (tmp -> next -> next != nullptr) // Will keep going until the next value is back or next value's key is greater than the key
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::Node* SkipList<K, V, Traits>::findNode(const K& key){
+    return std::as_const(*this).findNode(key);
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::Node* SkipList<K, V, Traits>::findNode(const K& key) const{
+    // The first node not less than key is either key's node or proof that
+    // it is missing, so a miss stops there instead of running to the back
+    Node * tmp{lowerBoundOnLayer(key, 0)};
+    if (tmp == this -> back or not keyEqual(tmp -> key, key))
     {
-        tmp = tmp -> next;
-        if (tmp -> key == key)
-        {   
-            return tmp;
-        }
+        throw std::out_of_range("Error");
     }
-    throw std::out_of_range("Error");
+    return tmp;
 }
-template <typename K, typename V>
-const V& SkipList<K, V>::find(const K& key) const {
-    
-    return findNode(key) -> value;
+
+template <typename K, typename V, typename Traits>
+const V& SkipList<K, V, Traits>::find(const K& key) const {
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::Find)};
+    count(&SkipListStats::lookups);
+    return valueOf(findNode(key));
 
 }
 
-template <typename K, typename V>
-V& SkipList<K, V>::find(const K& key) {
-    return findNode(key) -> value;
+template <typename K, typename V, typename Traits>
+V& SkipList<K, V, Traits>::find(const K& key) {
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::Find)};
+    count(&SkipListStats::lookups);
+    return valueOf(findNode(key));
 }
 
-template <typename K, typename V>
-bool SkipList<K, V>::insert(const K& key, const V& value) {
-    Node * tmp{this -> topFront}; // We will start the skip list finding feature from the top
-    while (tmp -> down != nullptr) // Go until tmp -> down is a nullptr which means that it is at the base layer and cannot go anymore
+template <typename K, typename V, typename Traits>
+bool SkipList<K, V, Traits>::insert(const K& key, const V& value) {
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::Insert)};
+    count(&SkipListStats::inserts);
+    PathArray path; //path[layer] is the node a promotion onto that layer goes after
+    Node * tmp{searchPath(key, path)}; //The last base layer node whose key is smaller than the key
+
+    if (tmp -> next -> next != nullptr and keyEqual(tmp -> next -> key, key)) // tmp -> next is the first key that is not smaller, so a duplicate would be there
     {
-        if (tmp -> next -> next != nullptr and tmp -> next -> key < key) //Tmp -> next -> next is used to find the tail since the tail will be the only one with a next nullptr
-        {
-            tmp = tmp -> next; // Set the tmp to the next node if the key is not at the back and the key is smaller than input key.
-        }
-        else
-        {
-            tmp = tmp -> down; //If tmp cannot find a value that matches the criteria then tmp will just go down
-        }
+        return false;
     }
+    linkNewTower(key, value, tmp, path);
+    return true;
+}
 
-    while (tmp -> next -> next != nullptr and tmp -> next -> key < key) // Will keep going until the next value is back or next value's key is greater than the key
+template <typename K, typename V, typename Traits>
+std::pair<typename SkipList<K, V, Traits>::const_iterator, bool> SkipList<K, V, Traits>::findOrInsert(const K& key, const V& value)
+{
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::Insert)};
+    count(&SkipListStats::inserts);
+    PathArray path;
+    Node * tmp{searchPath(key, path)};
+    if (tmp -> next -> next != nullptr and keyEqual(tmp -> next -> key, key))
     {
-        if(tmp -> key == key)
-        {
-            return false;
-        }
-        tmp = tmp -> next;
-    } 
+        return {const_iterator{tmp -> next}, false};
+    }
+    return {const_iterator{linkNewTower(key, value, tmp, path)}, true};
+}
 
-    Node * newNode = new Node(key, value); //Create a new node that we will connect to this point.
+template <typename K, typename V, typename Traits>
+V& SkipList<K, V, Traits>::mapped(const_iterator position)
+{
+    return valueOf(const_cast<Node *>(position.node));
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::Node* SkipList<K, V, Traits>::linkNewTower(const K& key, const V& value, Node* tmp, PathArray& path)
+{
+    //Links a new tower for *key* in after tmp, the last base layer node
+    //with a smaller key, promoting it past the nodes in *path*. Returns its
+    //base node.
+    Node * newNode = newBaseNode(key, value, baseNodePool, valueArena); //Create a new node that we will connect to this point.
+    count(&SkipListStats::nodesAllocated);
 
-    newNode -> previous = tmp; //Connects newNode's previous to tmp since tmp is the value that is smaller than it. Connect newNode's next to the value that would have been bigger which is next.
+    setPrevious(newNode, tmp, 0); //Connects newNode's previous to tmp since tmp is the value that is smaller than it. Connect newNode's next to the value that would have been bigger which is next.
     newNode -> next = tmp -> next;
 
     //Connect the old nodes next and  previous to newNode
-    tmp -> next -> previous = newNode;
+    setPrevious(tmp -> next, newNode, 0);
     tmp -> next = newNode;
     SkipListSize++;
 
@@ -474,73 +1409,464 @@ bool SkipList<K, V>::insert(const K& key, const V& value) {
     size_t layers{1};
     while (flipCoin(key, numberOfFlips))
     {
+        //Within a reserve the tower stops short rather than take a node
+        //from the global allocator
+        if (SkipListSize <= reservedKeys and indexNodePool.available() == 0)
+        {
+            break;
+        }
 
         //Check if layers are about to be exceeded add a new 
         if (layers == SkipListLayers - 1)
         {
-            Node * newTop = new Node({}, {});
-            Node * newTopBack = new Node({}, {});
-
-            //Connect the new layers with each other
-            newTop -> down = this -> topFront;
-            newTopBack -> down = this -> topBack;
-            newTop -> next = newTopBack;
-            newTopBack -> previous = newTop;
-
-            //Connect previous node to new nodes
-            this -> topFront -> up = newTop;
-            this -> topBack -> up = newTopBack;
-
-            this -> topFront = newTop;
-            this -> topBack = newTopBack;
-            SkipListLayers++;
+            addTopLayer();
+            path[SkipListLayers - 1] = this -> topFront; //The search never saw the new layer, which is empty
         }
 
         
-        while (randTmp -> up == nullptr) //If it is null ptr then it cannot be the value that led to TMP
-        {
-            randTmp = randTmp -> previous;
-        }
-        
-        Node * newLayer = new Node(key, value);
+        Node * newLayer = indexNodePool.create(key); //Index nodes only need the key
+        count(&SkipListStats::nodesAllocated);
+        count(&SkipListStats::promotions);
 
-        randTmp = randTmp -> up;
+        randTmp = path[layers]; //The search passed this node just before dropping below this layer
 
         //Connect nodes for newLayer
-        newLayer -> previous = randTmp;
+        setPrevious(newLayer, randTmp, layers);
         newLayer -> down = randTmp2;
         newLayer -> next = randTmp -> next;
         
         //Connect the key node to this new layer node
         randTmp2 -> up = newLayer;
-        randTmp -> next -> previous = newLayer;
+        setPrevious(randTmp -> next, newLayer, layers);
         randTmp -> next = newLayer;
 
         //Set the new layer node to randTmp2 so if it goes up again this is the one that it will connect to.
         randTmp2 = newLayer;
         
-        if (SkipListSize <= 16)
+        if (reachedLayerCap(SkipListSize, SkipListLayers))
         {
-            if (SkipListLayers == 13)
-            {
-                break;
-            }
+            break;
         }
-        if (SkipListSize > 16)
+        layers++;
+        numberOfFlips++;
+    }
+    return newNode;
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::insert_return_type SkipList<K, V, Traits>::insert(node_type&& node)
+{
+    if (node.empty())
+    {
+        return {end(), false, {}};
+    }
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::Insert)};
+    count(&SkipListStats::inserts);
+
+    PathArray path;
+    Node * tmp{searchPath(node.tower -> key, path)};
+    if (tmp -> next -> next != nullptr and keyEqual(tmp -> next -> key, node.tower -> key))
+    {
+        return {const_iterator{tmp -> next}, false, std::move(node)};
+    }
+    //The tower and its value stay where they are; this list takes over the
+    //handle's share of their chunks
+    moveTower(node.tower, node.baseNodes, node.indexNodes, node.values, baseNodePool, indexNodePool, valueArena);
+    Node * base{node.tower};
+    const K& key{base -> key};
+
+    //The key may have changed since the tower was extracted, so bring every copy up to date
+    for (Node * above = base -> up; above != nullptr; above = above -> up)
+    {
+        if (not keyEqual(above -> key, key))
         {
-            if (SkipListLayers == (3 * ceil(log2(SkipListSize)) + 1))
+            above -> key = key;
+            if constexpr (ABBREVIATED)
             {
-                break;
+                static_cast<IndexNode *>(above) -> prefix = abbreviate(key);
             }
         }
+    }
+
+    size_t layer{0};
+    for (Node * tmpNode = base; tmpNode != nullptr; tmpNode = tmpNode -> up, layer++)
+    {
+        if (layer == SkipListLayers - 1)
+        {
+            addTopLayer();
+            path[SkipListLayers - 1] = this -> topFront;
+        }
+        Node * previousNode{path[layer]};
+        setPrevious(tmpNode, previousNode, layer);
+        tmpNode -> next = previousNode -> next;
+        setPrevious(previousNode -> next, tmpNode, layer);
+        previousNode -> next = tmpNode;
+    }
+    SkipListSize++;
+
+    node.tower = nullptr;
+    return {const_iterator{base}, true, {}};
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::node_type SkipList<K, V, Traits>::extract(const K& key)
+{
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::Erase)};
+    count(&SkipListStats::erases);
+    PathArray path;
+    Node * tmp{searchPath(key, path) -> next};
+    if (tmp == this -> back or not keyEqual(tmp -> key, key))
+    {
+        return {};
+    }
+    //Share the storage before unlinking, so that running out of memory leaves the key where it was
+    node_type node;
+    moveTower(tmp, baseNodePool, indexNodePool, valueArena, node.baseNodes, node.indexNodes, node.values);
+
+    //Unlink each layer but keep the tower's own up and down links
+    size_t layer{0};
+    for (Node * tmpNode = tmp; tmpNode != nullptr; tmpNode = tmpNode -> up, layer++)
+    {
+        path[layer] -> next = tmpNode -> next;
+        setPrevious(tmpNode -> next, path[layer], layer);
+        tmpNode -> next = nullptr;
+    }
+    SkipListSize--;
+    node.tower = tmp;
+    return node;
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::reserve(size_t expectedKeys)
+{
+    if (expectedKeys <= SkipListSize)
+    {
+        return;
+    }
+    size_t newKeys{expectedKeys - SkipListSize};
+
+    //Layers stop growing at the layer cap for expectedKeys; each new one needs two sentinels
+    size_t layers{SkipListLayers};
+    while (not reachedLayerCap(expectedKeys, layers))
+    {
         layers++;
+    }
+    size_t sentinels{2 * (layers - SkipListLayers)};
+
+    //A fair coin puts one index node above each key on average
+    const size_t INDEX_SLACK{64};
+    baseNodePool.reserve(newKeys);
+    indexNodePool.reserve(newKeys + newKeys / 4 + INDEX_SLACK);
+    sentinelPool.reserve(sentinels);
+    if constexpr (not INLINE_VALUES)
+    {
+        valueArena.reserve(newKeys);
+    }
+    reservedKeys = std::max(reservedKeys, expectedKeys);
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::shrinkToFit()
+{
+    reservedKeys = 0;
+    baseNodePool.shrinkToFit();
+    indexNodePool.shrinkToFit();
+    sentinelPool.shrinkToFit();
+    if constexpr (not INLINE_VALUES)
+    {
+        valueArena.shrinkToFit();
+    }
+}
+
+template <typename K, typename V, typename Traits>
+size_t SkipList<K, V, Traits>::reservedNodes() const noexcept
+{
+    return baseNodePool.available() + indexNodePool.available() + sentinelPool.available();
+}
+
+template <typename K, typename V, typename Traits>
+size_t SkipList<K, V, Traits>::reservedValues() const noexcept
+{
+    if constexpr (INLINE_VALUES)
+    {
+        return 0;
+    }
+    else
+    {
+        return valueArena.available();
+    }
+}
+
+template <typename K, typename V, typename Traits>
+size_t SkipList<K, V, Traits>::storageBytes() const noexcept
+{
+    size_t bytes{baseNodePool.capacityBytes() + indexNodePool.capacityBytes() + sentinelPool.capacityBytes()};
+    if constexpr (not INLINE_VALUES)
+    {
+        bytes += valueArena.capacityBytes();
+    }
+    return bytes;
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::moveTower(Node * tower, NodePool<BaseNode>& fromBase,
+                                       NodePool<IndexNode>& fromIndex,
+                                       [[maybe_unused]] Arena& fromValues,
+                                       NodePool<BaseNode>& toBase, NodePool<IndexNode>& toIndex,
+                                       [[maybe_unused]] Arena& toValues)
+{
+    for (Node * tmp = tower; tmp != nullptr; tmp = tmp -> up)
+    {
+        if (tmp -> down == nullptr)
+        {
+            toBase.share(fromBase, static_cast<BaseNode *>(tmp));
+        }
+        else
+        {
+            toIndex.share(fromIndex, static_cast<IndexNode *>(tmp));
+        }
+    }
+    if constexpr (not INLINE_VALUES)
+    {
+        toValues.take(fromValues, static_cast<BaseNode *>(tower) -> value);
+    }
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::addTopLayer()
+{
+    Node * newTop = sentinelPool.create();
+    Node * newTopBack = sentinelPool.create();
+    count(&SkipListStats::nodesAllocated, 2);
+
+    //Connect the new layers with each other
+    newTop -> down = this -> topFront;
+    newTopBack -> down = this -> topBack;
+    newTop -> next = newTopBack;
+    setPrevious(newTopBack, newTop, SkipListLayers);
+
+    //Connect previous node to new nodes
+    this -> topFront -> up = newTop;
+    this -> topBack -> up = newTopBack;
+
+    this -> topFront = newTop;
+    this -> topBack = newTopBack;
+    SkipListLayers++;
+}
+
+template <typename K, typename V, typename Traits>
+size_t SkipList<K, V, Traits>::towerHeight(const K& key, size_t size, size_t& layers) const
+{
+    // Replays the promotion loop of insert without touching any nodes. *size*
+    // already counts *key*, and *layers* is grown the way insert would grow it.
+    size_t height{1};
+    size_t numberOfFlips{0};
+    while (flipCoin(key, numberOfFlips))
+    {
+        if (height == layers - 1)
+        {
+            layers++;
+        }
+        height++;
+        if (reachedLayerCap(size, layers))
+        {
+            break;
+        }
         numberOfFlips++;
     }
-    return true;
+    return height;
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::appendTower(const K& key, const V& value, size_t height, Segment& segment)
+{
+    Node * below{nullptr};
+    for (size_t layer = 0; layer < height; layer++)
+    {
+        Node * newNode = layer == 0 ? newBaseNode(key, value, segment.baseNodes, segment.values)
+                                    : segment.indexNodes.create(key);
+
+        //Stack the node on top of the one from the layer below
+        newNode -> down = below;
+        if (below != nullptr)
+        {
+            below -> up = newNode;
+        }
+
+        //Append the node to what this segment has built on this layer
+        if (segment.lasts[layer] == nullptr)
+        {
+            segment.firsts[layer] = newNode;
+        }
+        else
+        {
+            segment.lasts[layer] -> next = newNode;
+            setPrevious(newNode, segment.lasts[layer], layer);
+        }
+        segment.lasts[layer] = newNode;
+        below = newNode;
+    }
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::buildSegment(const std::vector<std::pair<K, V>>& entries,
+                                  const std::vector<uint8_t>& heights,
+                                  size_t begin, size_t end, Segment& segment)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        if (i > 0 and not (entries[i - 1].first < entries[i].first))
+        {
+            throw std::invalid_argument("Keys are not strictly increasing");
+        }
+        appendTower(entries[i].first, entries[i].second, heights[i], segment);
+    }
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::destroySegment(Segment& segment)
+{
+    for (size_t layer = 0; layer < segment.firsts.size(); layer++)
+    {
+        Node * current{segment.firsts[layer]};
+        while (current != nullptr)
+        {
+            Node * deleteNode{current};
+            current = (current == segment.lasts[layer]) ? nullptr : current -> next;
+            destroyContents(deleteNode, false); //The segment's pools and arena free the slots themselves
+        }
+    }
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::buildFromSorted(const std::vector<std::pair<K, V>>& entries,
+                                     size_t threads)
+{
+    if (not empty())
+    {
+        throw std::logic_error("buildFromSorted needs an empty skip list");
+    }
+    if (entries.empty())
+    {
+        return;
+    }
+
+    // Tower heights depend on how many layers the keys before them created,
+    // so they are worked out in one cheap pass before any node is allocated.
+    std::vector<uint8_t> heights(entries.size());
+    size_t layers{SkipListLayers};
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        heights[i] = static_cast<uint8_t>(towerHeight(entries[i].first, i + 1, layers));
+    }
+
+    // Small slices are not worth a thread of their own
+    const size_t MIN_ENTRIES_PER_THREAD{4096};
+    if (threads == 0)
+    {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::max<size_t>(1, std::min(threads, entries.size() / MIN_ENTRIES_PER_THREAD));
+
+    std::vector<Segment> segments;
+    segments.reserve(threads);
+    for (size_t t = 0; t < threads; t++)
+    {
+        segments.emplace_back(layers);
+    }
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    auto buildSlice = [&](size_t t)
+    {
+        try
+        {
+            buildSegment(entries, heights, entries.size() * t / threads,
+                         entries.size() * (t + 1) / threads, segments[t]);
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+        }
+    };
+    for (size_t t = 1; t < threads; t++)
+    {
+        //A thread that cannot start fails its slice, so the ones already
+        //running are still joined below
+        try
+        {
+            workers.emplace_back(buildSlice, t);
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+        }
+    }
+    buildSlice(0);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            for (Segment& segment : segments)
+            {
+                destroySegment(segment);
+            }
+            std::rethrow_exception(error);
+        }
+    }
+
+    linkSegments(segments, layers, entries.size());
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::linkSegments(std::vector<Segment>& segments, size_t layers, size_t size)
+{
+    while (SkipListLayers < layers)
+    {
+        addTopLayer();
+    }
+
+    //Stitch the segments together between the sentinels one layer at a time
+    Node * layerFront{this -> front};
+    Node * layerBack{this -> back};
+    for (size_t layer = 0; layer < layers; layer++)
+    {
+        Node * tmp{layerFront};
+        for (Segment& segment : segments)
+        {
+            if (segment.firsts[layer] != nullptr)
+            {
+                tmp -> next = segment.firsts[layer];
+                setPrevious(segment.firsts[layer], tmp, layer);
+                tmp = segment.lasts[layer];
+            }
+        }
+        tmp -> next = layerBack;
+        setPrevious(layerBack, tmp, layer);
+
+        layerFront = layerFront -> up;
+        layerBack = layerBack -> up;
+    }
+    for (Segment& segment : segments)
+    {
+        baseNodePool.splice(segment.baseNodes);
+        indexNodePool.splice(segment.indexNodes);
+        if constexpr (not INLINE_VALUES)
+        {
+            valueArena.splice(segment.values);
+        }
+    }
+    SkipListSize = size;
 }
 
-template <typename K, typename V>
-std::vector<K> SkipList<K, V>::allKeysInOrder() const {
+template <typename K, typename V, typename Traits>
+std::vector<K> SkipList<K, V, Traits>::allKeysInOrder() const {
     std::vector<K> keys{}; //Empty Vector
 
     Node * tmp {this -> front -> next}; //Make node pointer to the first value after front
@@ -554,36 +1880,422 @@ std::vector<K> SkipList<K, V>::allKeysInOrder() const {
     return keys;
 }
 
-template <typename K, typename V>
-bool SkipList<K, V>::isSmallestKey(const K& key) const {
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::save(const std::string& path, bool withHeights) const
+{
+    BinaryWriter writer{path};
+    writer.writeValue(SNAPSHOT_MAGIC);
+    writer.writeValue(SNAPSHOT_VERSION);
+    writer.writeValue(withHeights ? SNAPSHOT_WITH_HEIGHTS : uint32_t{0});
+    writer.writeValue(static_cast<uint64_t>(SkipListSize));
+    writer.writeValue(static_cast<uint64_t>(SkipListLayers));
+
+    std::vector<K> keys;
+    std::vector<V> values;
+    std::vector<uint8_t> heights;
+    keys.reserve(SNAPSHOT_BLOCK_SIZE);
+    values.reserve(SNAPSHOT_BLOCK_SIZE);
+    heights.reserve(SNAPSHOT_BLOCK_SIZE);
+
+    auto writeBlock = [&]()
+    {
+        writer.writeValue(static_cast<uint32_t>(keys.size()));
+        BinaryCodec<K>::write(writer, keys.data(), keys.size());
+        BinaryCodec<V>::write(writer, values.data(), values.size());
+        if (withHeights)
+        {
+            writer.write(heights.data(), heights.size());
+        }
+        keys.clear();
+        values.clear();
+        heights.clear();
+    };
+
+    for (Node * tmp = this -> front -> next; tmp != this -> back; tmp = tmp -> next)
+    {
+        keys.push_back(tmp -> key);
+        values.push_back(valueOf(tmp));
+        if (withHeights)
+        {
+            size_t height{1};
+            for (Node * level = tmp -> up; level != nullptr; level = level -> up)
+            {
+                height++;
+            }
+            heights.push_back(static_cast<uint8_t>(height));
+        }
+        if (keys.size() == SNAPSHOT_BLOCK_SIZE)
+        {
+            writeBlock();
+        }
+    }
+    if (not keys.empty())
+    {
+        writeBlock();
+    }
+    writer.finish();
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::load(const std::string& path)
+{
+    if (not empty())
+    {
+        throw std::logic_error("load needs an empty skip list");
+    }
+
+    BinaryReader reader{path};
+    if (reader.readValue<uint64_t>() != SNAPSHOT_MAGIC or
+        reader.readValue<uint32_t>() != SNAPSHOT_VERSION)
+    {
+        throw std::runtime_error(path + " is not a skip list snapshot");
+    }
+    const bool withHeights{reader.readValue<uint32_t>() == SNAPSHOT_WITH_HEIGHTS};
+    const auto size = static_cast<size_t>(reader.readValue<uint64_t>());
+    size_t layers{static_cast<size_t>(reader.readValue<uint64_t>())};
+    // Any list has its base layer and a top layer of sentinels alone. An
+    // empty list that once grew keeps its layers, and the towers from the
+    // file only fill the lower ones.
+    if (layers < 2 or layers > UINT8_MAX)
+    {
+        throw std::runtime_error(path + " has an impossible layer count");
+    }
+    if (not withHeights)
+    {
+        layers = SkipListLayers;
+    }
+
+    // Towers are built off to the side and only linked in once the whole
+    // file has passed its checksum.
+    Segment segment{UINT8_MAX};
+    std::vector<K> keys;
+    std::vector<V> values;
+    std::vector<uint8_t> heights;
+    try
+    {
+        size_t loaded{0};
+        while (loaded < size)
+        {
+            auto count = static_cast<size_t>(reader.readValue<uint32_t>());
+            if (count == 0 or count > size - loaded or count > SNAPSHOT_BLOCK_SIZE)
+            {
+                throw std::runtime_error(path + " has a corrupt block");
+            }
+            keys.resize(count);
+            values.resize(count);
+            BinaryCodec<K>::read(reader, keys.data(), count);
+            BinaryCodec<V>::read(reader, values.data(), count);
+            if (withHeights)
+            {
+                heights.resize(count);
+                reader.read(heights.data(), count);
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                if (segment.lasts[0] != nullptr and not (segment.lasts[0] -> key < keys[i]))
+                {
+                    throw std::runtime_error(path + " has keys out of order");
+                }
+                size_t height{withHeights ? heights[i] : towerHeight(keys[i], loaded + 1, layers)};
+                if (height == 0 or height >= layers)
+                {
+                    throw std::runtime_error(path + " has an impossible key height");
+                }
+                appendTower(keys[i], values[i], height, segment);
+                loaded++;
+            }
+        }
+        reader.verifyChecksum();
+    }
+    catch (...)
+    {
+        destroySegment(segment);
+        throw;
+    }
+
+    std::vector<Segment> segments;
+    segments.push_back(std::move(segment));
+    linkSegments(segments, layers, size);
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::Node* SkipList<K, V, Traits>::lowerBoundOnLayer(const K& key, size_t layer) const
+{
+    // Returns the first node on *layer* whose key is not less than *key*,
+    // which is the layer's back sentinel if there is none.
+    const Prefix prefix{abbreviate(key)};
+    Node * tmp{this -> topFront};
+    size_t currentLayer{SkipListLayers - 1};
+    while (true)
+    {
+        while (tmp -> next -> next != nullptr and nodeLess(tmp -> next, currentLayer, key, prefix))
+        {
+            tmp = tmp -> next;
+            count(&SkipListStats::nextHops);
+        }
+        if (currentLayer == layer)
+        {
+            return tmp -> next;
+        }
+        tmp = tmp -> down;
+        count(&SkipListStats::downHops);
+        currentLayer--;
+    }
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::Node* SkipList<K, V, Traits>::searchPath(const K& key, PathArray& path) const
+{
+    // Fills path[layer] with the last node on each layer whose key is less
+    // than *key*, and returns the one on the base layer.
+    const Prefix prefix{abbreviate(key)};
+    Node * tmp{this -> topFront};
+    size_t layer{SkipListLayers - 1};
+    while (true)
+    {
+        while (tmp -> next -> next != nullptr and nodeLess(tmp -> next, layer, key, prefix))
+        {
+            tmp = tmp -> next;
+            count(&SkipListStats::nextHops);
+        }
+        path[layer] = tmp;
+        if (layer == 0)
+        {
+            return tmp;
+        }
+        tmp = tmp -> down;
+        count(&SkipListStats::downHops);
+        layer--;
+    }
+}
+
+template <typename K, typename V, typename Traits>
+std::vector<typename SkipList<K, V, Traits>::Node *> SkipList<K, V, Traits>::scanChunks(const K& lo, const K& hi,
+                                                                       size_t chunks) const
+{
+    // Chunk i of the scan is the base layer run [bounds[i], bounds[i + 1]).
+    Node * first{lowerBoundOnLayer(lo, 0)};
+    std::vector<Node *> bounds{first};
+    if (not (lo < hi))
+    {
+        return bounds;
+    }
+
+    // The highest layer with enough nodes in range supplies the split points.
+    // Layers halve in size going up, so it has at most about twice as many.
+    size_t splitLayer{1};
+    for (size_t layer = SkipListLayers - 2; layer > 1; layer--)
+    {
+        size_t count{0};
+        for (Node * tmp = lowerBoundOnLayer(lo, layer);
+             tmp -> next != nullptr and tmp -> key < hi and count < chunks;
+             tmp = tmp -> next)
+        {
+            count++;
+        }
+        if (count == chunks)
+        {
+            splitLayer = layer;
+            break;
+        }
+    }
+
+    for (Node * tmp = lowerBoundOnLayer(lo, splitLayer);
+         tmp -> next != nullptr and tmp -> key < hi;
+         tmp = tmp -> next)
+    {
+        Node * split{tmp};
+        for (size_t layer = 0; layer < splitLayer; layer++)
+        {
+            split = split -> down;
+        }
+        if (split != first)
+        {
+            bounds.push_back(split);
+        }
+    }
+    bounds.push_back(lowerBoundOnLayer(hi, 0));
+    return bounds;
+}
+
+template <typename K, typename V, typename Traits>
+template <typename F>
+void SkipList<K, V, Traits>::parallelForEach(const K& lo, const K& hi, F fn, size_t threads) const
+{
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::RangeScan)};
+    const size_t CHUNKS_PER_THREAD{4};
+    if (threads == 0)
+    {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    std::vector<Node *> bounds{scanChunks(lo, hi, threads * CHUNKS_PER_THREAD)};
+    runWorkStealing(bounds.size() - 1, threads, [&](size_t chunk)
+    {
+        for (Node * tmp = bounds[chunk]; tmp != bounds[chunk + 1]; tmp = tmp -> next)
+        {
+            fn(tmp -> key, valueOf(tmp));
+        }
+    });
+}
+
+template <typename K, typename V, typename Traits>
+template <typename T, typename Map, typename Combine>
+T SkipList<K, V, Traits>::parallelReduce(const K& lo, const K& hi, T identity, Map map,
+                                 Combine combine, size_t threads) const
+{
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::RangeScan)};
+    // Wrapped so that a std::vector<bool> never packs two chunks into one word
+    struct Partial
+    {
+        T result;
+    };
+
+    const size_t CHUNKS_PER_THREAD{4};
+    if (threads == 0)
+    {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    std::vector<Node *> bounds{scanChunks(lo, hi, threads * CHUNKS_PER_THREAD)};
+    std::vector<Partial> partials(bounds.size() - 1, Partial{identity});
+    runWorkStealing(partials.size(), threads, [&](size_t chunk)
+    {
+        T result{identity};
+        for (Node * tmp = bounds[chunk]; tmp != bounds[chunk + 1]; tmp = tmp -> next)
+        {
+            result = combine(std::move(result), map(tmp -> key, valueOf(tmp)));
+        }
+        partials[chunk].result = std::move(result);
+    });
+
+    T result{std::move(identity)};
+    for (Partial& partial : partials)
+    {
+        result = combine(std::move(result), std::move(partial.result));
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Traits>
+bool SkipList<K, V, Traits>::contains(const K& key) const
+{
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::Find)};
+    count(&SkipListStats::lookups);
+    Node * tmp{lowerBoundOnLayer(key, 0)};
+    return tmp != this -> back and keyEqual(tmp -> key, key);
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::const_iterator SkipList<K, V, Traits>::begin() const
+{
+    return const_iterator{this -> front -> next};
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::const_iterator SkipList<K, V, Traits>::end() const
+{
+    return const_iterator{this -> back};
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipList<K, V, Traits>::const_iterator SkipList<K, V, Traits>::lower_bound(const K& key) const
+{
+    count(&SkipListStats::lookups);
+    return const_iterator{lowerBoundOnLayer(key, 0)};
+}
+
+template <typename K, typename V, typename Traits>
+bool SkipList<K, V, Traits>::isSmallestKey(const K& key) const {
     findNode(key);
     return (this -> front -> next -> key == key);
 }
 
-template <typename K, typename V>
-bool SkipList<K, V>::isLargestKey(const K& key) const {
-    findNode(key);
-    return (this -> back -> previous -> key == key);
+template <typename K, typename V, typename Traits>
+bool SkipList<K, V, Traits>::isLargestKey(const K& key) const {
+    return (findNode(key) -> next == this -> back);
 }
 
-template <typename K, typename V>
-void SkipList<K, V>::erase(const K& key) {
-    Node * tmp{findNode(key)}; //Find the node that this value is at
-    while (tmp != nullptr)
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::erase(const K& key) {
+    [[maybe_unused]] auto timer{timeOperation(LatencyOperation::Erase)};
+    count(&SkipListStats::erases);
+    if constexpr (Traits::BACK_LINKS == BackLinks::All)
     {
-        Node * tmpPrevious{tmp -> previous};
-        Node * tmpNext{tmp -> next};
-        //Store the nodes next and previous values so can connect them
+        Node * tmp{findNode(key)}; //Find the node that this value is at
+        while (tmp != nullptr)
+        {
+            Node * tmpPrevious{tmp -> previous};
+            Node * tmpNext{tmp -> next};
+            //Store the nodes next and previous values so can connect them
 
-        tmpPrevious -> next = tmpNext;
-        tmpNext -> previous = tmpPrevious;
+            tmpPrevious -> next = tmpNext;
+            tmpNext -> previous = tmpPrevious;
 
-        Node * deleteNode{tmp}; //Keep track so can delete
-        tmp = tmp -> up;
-        delete deleteNode;
+            Node * deleteNode{tmp}; //Keep track so can delete
+            tmp = tmp -> up;
+            destroyNode(deleteNode);
+            count(&SkipListStats::nodesFreed);
+        }
+    }
+    else
+    {
+        //The nodes before the tower on each layer come from the search path
+        PathArray path;
+        Node * tmp{searchPath(key, path) -> next};
+        if (tmp == this -> back or not keyEqual(tmp -> key, key))
+        {
+            throw std::out_of_range("Error");
+        }
+        for (size_t layer = 0; tmp != nullptr; layer++)
+        {
+            path[layer] -> next = tmp -> next;
+            setPrevious(tmp -> next, path[layer], layer);
+
+            Node * deleteNode{tmp};
+            tmp = tmp -> up;
+            destroyNode(deleteNode);
+            count(&SkipListStats::nodesFreed);
+        }
     }
     SkipListSize--;
 }
 
+template <typename K, typename V, typename Traits>
+const SkipListStats& SkipList<K, V, Traits>::stats() const noexcept
+    requires Traits::COUNT_OPERATIONS
+{
+    return statistics;
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::resetStats() noexcept
+    requires Traits::COUNT_OPERATIONS
+{
+    statistics = {};
+}
+
+template <typename K, typename V, typename Traits>
+LatencyHistogram SkipList<K, V, Traits>::latencyHistogram(LatencyOperation operation) const
+    requires Traits::RECORD_LATENCY
+{
+    return latency.histogram(operation);
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::writeLatencyPercentiles(std::ostream& out) const
+    requires Traits::RECORD_LATENCY
+{
+    latency.writePercentiles(out);
+}
+
+template <typename K, typename V, typename Traits>
+void SkipList<K, V, Traits>::resetLatency()
+    requires Traits::RECORD_LATENCY
+{
+    latency.reset();
+}
+
 }  // namespace shindler::ics46::project2
 #endif
@@ -0,0 +1,108 @@
+#ifndef ___SKIP_LIST_REPORT_HPP
+#define ___SKIP_LIST_REPORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Shape and memory use of a SkipList, as returned by
+ * SkipList::structureReport().
+ *
+ * Layer and height vectors are indexed from the base layer: entry 0 is
+ * layer S_0, or keys of height 1.
+ */
+struct SkipListReport {
+    size_t size{0};
+    size_t layers{0};
+
+    // Key nodes on each layer, not counting the two sentinels
+    std::vector<size_t> nodesPerLayer;
+    // Layers holding no key nodes. The top layer of a list built by insert
+    // is always empty, so a healthy list reports 1.
+    size_t emptyLayers{0};
+
+    // Keys of each height, next to size * 2^-height, what a fair coin
+    // would give on average
+    std::vector<size_t> heightHistogram;
+    std::vector<double> expectedHeightHistogram;
+    // Total variation distance between the two, from 0 (identical) to 1
+    // (disjoint). A degenerate coin shows up as a large value here.
+    double heightDeviation{0};
+
+    // Hops (steps along a layer plus steps down) taken by a search for
+    // each key, averaged and at worst
+    double averageSearchPath{0};
+    size_t maxSearchPath{0};
+
+    // Nodes, sentinels included, and the heap memory the keys and values in
+    // them own on top of that (e.g. long std::string buffers)
+    size_t nodeCount{0};
+    size_t nodeBytes{0};
+    size_t keyHeapBytes{0};
+    size_t valueHeapBytes{0};
+
+    [[nodiscard]] size_t totalBytes() const noexcept {
+        return nodeBytes + keyHeapBytes + valueHeapBytes;
+    }
+
+    [[nodiscard]] double bytesPerKey() const noexcept {
+        return size == 0 ? 0.0
+                         : static_cast<double>(totalBytes()) / static_cast<double>(size);
+    }
+
+    // The report as one JSON object
+    [[nodiscard]] std::string toJson() const;
+};
+
+/**
+ * @brief Heap bytes owned by *item* beyond sizeof(item): the buffer of a
+ * std::string too long for its inline storage, and nothing for anything
+ * else.
+ */
+template <typename T>
+size_t heapBytes(const T& item) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        const char* begin{reinterpret_cast<const char*>(&item)};
+        const char* data{item.data()};
+        bool isInline{data >= begin and data < begin + sizeof(item)};
+        return isInline ? 0 : item.capacity() + 1;
+    } else {
+        return 0;
+    }
+}
+
+inline std::string SkipListReport::toJson() const {
+    std::ostringstream out;
+    auto writeArray = [&out](const auto& values) {
+        out << "[";
+        for (size_t i = 0; i < values.size(); i++) {
+            out << (i == 0 ? "" : ", ") << values[i];
+        }
+        out << "]";
+    };
+
+    out << "{\"size\": " << size << ", \"layers\": " << layers
+        << ", \"nodes_per_layer\": ";
+    writeArray(nodesPerLayer);
+    out << ", \"empty_layers\": " << emptyLayers << ", \"height_histogram\": ";
+    writeArray(heightHistogram);
+    out << ", \"expected_height_histogram\": ";
+    writeArray(expectedHeightHistogram);
+    out << ", \"height_deviation\": " << heightDeviation
+        << ", \"average_search_path\": " << averageSearchPath
+        << ", \"max_search_path\": " << maxSearchPath << ", \"node_count\": " << nodeCount
+        << ", \"node_bytes\": " << nodeBytes << ", \"key_heap_bytes\": " << keyHeapBytes
+        << ", \"value_heap_bytes\": " << valueHeapBytes
+        << ", \"total_bytes\": " << totalBytes() << ", \"bytes_per_key\": " << bytesPerKey()
+        << "}";
+    return out.str();
+}
+
+}  // namespace shindler::ics46::project2
+#endif
@@ -0,0 +1,229 @@
+#ifndef ___SKIP_MULTI_MAP_HPP
+#define ___SKIP_MULTI_MAP_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "SkipList.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief An ordered multimap on the SkipList engine: a key may be inserted
+ * any number of times, and its values are kept in insertion order.
+ *
+ * Each distinct key has one tower, so a key is stored once however many
+ * values it has. Its base node holds the first value itself and any later
+ * ones in a vector, so a key with a single value allocates nothing besides
+ * its node. insert, equal_range and count cost one SkipList search plus
+ * the values involved, O(log n + k). Erasing one entry through an iterator
+ * shifts the later values of that key down, and only searches when it
+ * erases the key's last value.
+ *
+ * Iterators stay valid while other keys are inserted or erased. Inserting
+ * or erasing a value of a key invalidates references to that key's values
+ * and iterators past the changed position within it.
+ */
+template <typename K, typename V, typename Traits = SkipListTraits>
+class SkipMultiMap {
+    // A key's values in insertion order
+    struct Values {
+        V first;
+        std::vector<V> rest;
+
+        [[nodiscard]] size_t size() const noexcept { return 1 + rest.size(); }
+        [[nodiscard]] const V& operator[](size_t index) const {
+            return index == 0 ? first : rest[index - 1];
+        }
+        // Only while there is more than one value
+        void erase(size_t index) {
+            if (index == 0) {
+                first = std::move(rest.front());
+                rest.erase(rest.begin());
+            } else {
+                rest.erase(rest.begin() + static_cast<std::ptrdiff_t>(index - 1));
+            }
+        }
+    };
+
+    using List = SkipList<K, Values, Traits>;
+
+   public:
+    // Forward iterator over every entry, in increasing key order and then
+    // insertion order; dereferences to a pair of references like
+    // SkipList::const_iterator.
+    class const_iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = std::pair<const K&, const V&>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            auto [key, values] = *position;
+            return {key, values[index]};
+        }
+
+        const_iterator& operator++() {
+            if (++index == (*position).second.size()) {
+                ++position;
+                index = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous{*this};
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const = default;
+
+       private:
+        friend class SkipMultiMap;
+        explicit const_iterator(typename List::const_iterator position, size_t index = 0)
+            : position{position}, index{index} {}
+        typename List::const_iterator position;
+        // Which of the key's values
+        size_t index{0};
+    };
+
+    SkipMultiMap() = default;
+
+    SkipMultiMap(const SkipMultiMap&) = delete;
+    SkipMultiMap(SkipMultiMap&&) = delete;
+    SkipMultiMap& operator=(const SkipMultiMap&) = delete;
+    SkipMultiMap& operator=(SkipMultiMap&&) = delete;
+
+    // Entries, counting every value of every key
+    [[nodiscard]] size_t size() const noexcept { return entries; }
+    [[nodiscard]] bool empty() const noexcept { return entries == 0; }
+
+    // Distinct keys
+    [[nodiscard]] size_t keyCount() const noexcept { return list.size(); }
+
+    // Same contracts as the SkipList members of the same names.
+    [[nodiscard]] size_t layers() const noexcept { return list.layers(); }
+    [[nodiscard]] size_t height(const K& key) const { return list.height(key); }
+    [[nodiscard]] bool contains(const K& key) const { return list.contains(key); }
+
+    // Add an entry after any others with the same key and return an
+    // iterator to it. This always succeeds.
+    const_iterator insert(const K& key, const V& value);
+
+    // Number of entries with this key
+    [[nodiscard]] size_t count(const K& key) const;
+
+    // The first entry with this key, or end() if there is none
+    [[nodiscard]] const_iterator find(const K& key) const;
+
+    // The entries with this key, in insertion order, as [first, second)
+    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(const K& key) const;
+
+    // Erase every entry with this key and return how many there were.
+    size_t erase(const K& key);
+
+    // Erase the entry at *position*, which must not be end(), and return an
+    // iterator to the entry after it.
+    const_iterator erase(const_iterator position);
+
+    [[nodiscard]] const_iterator begin() const { return const_iterator{list.begin()}; }
+    [[nodiscard]] const_iterator end() const { return const_iterator{list.end()}; }
+
+    // Return an iterator to the first entry whose key is not less than
+    // *key*, or end() if there is none.
+    [[nodiscard]] const_iterator lower_bound(const K& key) const {
+        return const_iterator{list.lower_bound(key)};
+    }
+
+   private:
+    List list;
+    size_t entries{0};
+};
+
+template <typename K, typename V, typename Traits>
+typename SkipMultiMap<K, V, Traits>::const_iterator SkipMultiMap<K, V, Traits>::insert(
+    const K& key, const V& value) {
+    Values added{value, {}};
+    auto [position, inserted] = list.findOrInsert(key, added);
+    entries++;
+    if (inserted) {
+        return const_iterator{position};
+    }
+    Values& values{list.mapped(position)};
+    values.rest.push_back(std::move(added.first));
+    return const_iterator{position, values.size() - 1};
+}
+
+template <typename K, typename V, typename Traits>
+size_t SkipMultiMap<K, V, Traits>::count(const K& key) const {
+    auto position = list.lower_bound(key);
+    if (position == list.end() or not((*position).first == key)) {
+        return 0;
+    }
+    return (*position).second.size();
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipMultiMap<K, V, Traits>::const_iterator SkipMultiMap<K, V, Traits>::find(
+    const K& key) const {
+    auto position = list.lower_bound(key);
+    if (position == list.end() or not((*position).first == key)) {
+        return end();
+    }
+    return const_iterator{position};
+}
+
+template <typename K, typename V, typename Traits>
+std::pair<typename SkipMultiMap<K, V, Traits>::const_iterator,
+          typename SkipMultiMap<K, V, Traits>::const_iterator>
+SkipMultiMap<K, V, Traits>::equal_range(const K& key) const {
+    auto position = list.lower_bound(key);
+    if (position == list.end() or not((*position).first == key)) {
+        return {const_iterator{position}, const_iterator{position}};
+    }
+    auto next = position;
+    ++next;
+    return {const_iterator{position}, const_iterator{next}};
+}
+
+template <typename K, typename V, typename Traits>
+size_t SkipMultiMap<K, V, Traits>::erase(const K& key) {
+    auto node = list.extract(key);
+    if (node.empty()) {
+        return 0;
+    }
+    size_t erased{node.mapped().size()};
+    entries -= erased;
+    return erased;
+}
+
+template <typename K, typename V, typename Traits>
+typename SkipMultiMap<K, V, Traits>::const_iterator SkipMultiMap<K, V, Traits>::erase(
+    const_iterator position) {
+    Values& values{list.mapped(position.position)};
+    entries--;
+    if (values.size() > 1) {
+        values.erase(position.index);
+        if (position.index < values.size()) {
+            return position;
+        }
+        ++position.position;
+        return const_iterator{position.position};
+    }
+    auto next = position.position;
+    ++next;
+    // A copy, since erasing the last value frees the node holding the key
+    K key{(*position.position).first};
+    list.erase(key);
+    return const_iterator{next};
+}
+
+}  // namespace shindler::ics46::project2
+#endif
@@ -0,0 +1,130 @@
+#ifndef ___SKIP_SET_HPP
+#define ___SKIP_SET_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "SkipList.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief The value type of a SkipSet's underlying SkipList. It is empty, and
+ * SkipSetTraits tell the list to store nothing for it.
+ */
+struct SkipSetMember {};
+
+/**
+ * @brief *Traits* with STORE_VALUES turned off, for a SkipSet's list.
+ */
+template <typename Traits>
+struct SkipSetTraits : Traits {
+    static constexpr bool STORE_VALUES{false};
+};
+
+/**
+ * @brief An ordered set of keys on the SkipList engine.
+ *
+ * Keys are promoted, searched and unlinked exactly as in a SkipList with
+ * the same Traits, so both build the same towers for the same keys. The
+ * nodes hold links and a key and nothing else: no value and no padding for
+ * one.
+ */
+template <typename K, typename Traits = SkipListTraits>
+class SkipSet {
+    using List = SkipList<K, SkipSetMember, SkipSetTraits<Traits>>;
+
+   public:
+    // Forward iterator over the keys in increasing order.
+    class const_iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = K;
+        using reference = const K&;
+        using pointer = const K*;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        reference operator*() const { return (*position).first; }
+        pointer operator->() const { return &(*position).first; }
+
+        // Height of the current key, like SkipSet::height but without the
+        // search.
+        [[nodiscard]] size_t height() const { return position.height(); }
+
+        const_iterator& operator++() {
+            ++position;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous{*this};
+            ++position;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const = default;
+
+       private:
+        friend class SkipSet;
+        explicit const_iterator(typename List::const_iterator position)
+            : position{position} {}
+        typename List::const_iterator position;
+    };
+
+    SkipSet() = default;
+
+    SkipSet(const SkipSet&) = delete;
+    SkipSet(SkipSet&&) = delete;
+    SkipSet& operator=(const SkipSet&) = delete;
+    SkipSet& operator=(SkipSet&&) = delete;
+
+    // Same contracts as the SkipList members of the same names.
+    [[nodiscard]] size_t size() const noexcept { return list.size(); }
+    [[nodiscard]] bool empty() const noexcept { return list.empty(); }
+    [[nodiscard]] size_t layers() const noexcept { return list.layers(); }
+    [[nodiscard]] size_t height(const K& key) const { return list.height(key); }
+    [[nodiscard]] const K& nextKey(const K& key) const { return list.nextKey(key); }
+    [[nodiscard]] const K& previousKey(const K& key) const { return list.previousKey(key); }
+    [[nodiscard]] bool isSmallestKey(const K& key) const { return list.isSmallestKey(key); }
+    [[nodiscard]] bool isLargestKey(const K& key) const { return list.isLargestKey(key); }
+    [[nodiscard]] bool contains(const K& key) const { return list.contains(key); }
+    [[nodiscard]] std::vector<K> allKeysInOrder() const { return list.allKeysInOrder(); }
+    [[nodiscard]] SkipListReport structureReport() const { return list.structureReport(); }
+    void erase(const K& key) { list.erase(key); }
+
+    // Return true if the key was added, false if it was already there.
+    bool insert(const K& key) { return list.insert(key, {}); }
+
+    // Fill an empty set from strictly increasing keys, as
+    // SkipList::buildFromSorted does, with the same exceptions.
+    void buildFromSorted(const std::vector<K>& keys, size_t threads = 0);
+
+    [[nodiscard]] const_iterator begin() const { return const_iterator{list.begin()}; }
+    [[nodiscard]] const_iterator end() const { return const_iterator{list.end()}; }
+
+    // Return an iterator to the smallest key that is not less than *key*,
+    // or end() if there is none.
+    [[nodiscard]] const_iterator lower_bound(const K& key) const {
+        return const_iterator{list.lower_bound(key)};
+    }
+
+   private:
+    List list;
+};
+
+template <typename K, typename Traits>
+void SkipSet<K, Traits>::buildFromSorted(const std::vector<K>& keys, size_t threads) {
+    std::vector<std::pair<K, SkipSetMember>> entries;
+    entries.reserve(keys.size());
+    for (const K& key : keys) {
+        entries.emplace_back(key, SkipSetMember{});
+    }
+    list.buildFromSorted(entries, threads);
+}
+
+}  // namespace shindler::ics46::project2
+#endif
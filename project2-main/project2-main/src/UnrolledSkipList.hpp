@@ -0,0 +1,459 @@
+#ifndef ___UNROLLED_SKIP_LIST_HPP
+#define ___UNROLLED_SKIP_LIST_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "KeySearch.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Entries per block that keep an UnrolledSkipList block's keys and
+ * values within about four cache lines, but never fewer than 8.
+ */
+template <typename K, typename V>
+constexpr size_t defaultBlockEntries() {
+    const size_t BLOCK_BYTES{256};
+    return std::max<size_t>(8, BLOCK_BYTES / (sizeof(K) + sizeof(V)));
+}
+
+/**
+ * @brief Skip list whose base layer is a linked list of sorted blocks of
+ * up to B keys and values, instead of one node per key.
+ *
+ * Keys and values sit in two arrays per block, so a search ends with a
+ * search over contiguous keys (vector compares for integer keys, see
+ * countLess()), and scans and allKeysInOrder stream through memory with
+ * one block hop per B entries. The index layers above are an ordinary
+ * skip list over blocks, keyed by each block's first key; a block's tower
+ * height is drawn from a fair coin when the block is created.
+ *
+ * A full block splits in half on insert. A block that falls below B / 4
+ * entries on erase is merged with a neighbour when the two fit in one
+ * block. The first block is never indexed (searches below every tower land
+ * in it), so it is the only block that can be empty, and only when the
+ * whole list is.
+ *
+ * K and V must be default constructible, like SkipList's.
+ */
+template <typename K, typename V, size_t B = defaultBlockEntries<K, V>()>
+class UnrolledSkipList {
+    static_assert(B >= 4, "Blocks need room to split and merge");
+
+   private:
+    struct IndexNode;
+
+    struct Block {
+        size_t count{0};
+        std::array<K, B> keys{};
+        std::array<V, B> values{};
+        Block* next{nullptr};
+        Block* previous{nullptr};
+        // Top of this block's index tower, or nullptr if it has none
+        IndexNode* tower{nullptr};
+    };
+
+    // A layer's head has no key and points at the first block
+    struct IndexNode {
+        K key{};
+        IndexNode* next{nullptr};
+        IndexNode* down{nullptr};
+        Block* block{nullptr};
+    };
+
+    static constexpr size_t MAX_INDEX_LAYERS{32};
+    static constexpr size_t MIN_ENTRIES{B / 4};
+
+    Block* first;
+    // heads[i] starts index layer i + 1
+    std::vector<IndexNode*> heads;
+    size_t entries{0};
+    size_t blocks{1};
+    std::minstd_rand coin{46};
+
+    Block* findBlock(const K& key, IndexNode** path = nullptr) const;
+    static size_t position(const Block* block, const K& key);
+    void splitBlock(Block* block, IndexNode** path);
+    void rebalance(Block* block);
+    static void updateTowerKey(Block* block);
+    void removeTower(Block* block);
+    void unlinkBlock(Block* block);
+
+   public:
+    // Forward iterator over the keys in increasing order; dereferences to
+    // a pair of references like SkipList::const_iterator.
+    class const_iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = std::pair<const K&, const V&>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return {block->keys[index], block->values[index]};
+        }
+
+        const_iterator& operator++() {
+            if (++index == block->count) {
+                block = block->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous{*this};
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const = default;
+
+       private:
+        friend class UnrolledSkipList;
+        const_iterator(const Block* block, size_t index) : block{block}, index{index} {}
+        const Block* block{nullptr};
+        size_t index{0};
+    };
+
+    UnrolledSkipList() : first{new Block} {}
+
+    UnrolledSkipList(const UnrolledSkipList&) = delete;
+    UnrolledSkipList(UnrolledSkipList&&) = delete;
+    UnrolledSkipList& operator=(const UnrolledSkipList&) = delete;
+    UnrolledSkipList& operator=(UnrolledSkipList&&) = delete;
+
+    ~UnrolledSkipList();
+
+    [[nodiscard]] size_t size() const noexcept { return entries; }
+    [[nodiscard]] bool empty() const noexcept { return entries == 0; }
+
+    // Index layers plus the block layer
+    [[nodiscard]] size_t layers() const noexcept { return heads.size() + 1; }
+    [[nodiscard]] size_t blockCount() const noexcept { return blocks; }
+    static constexpr size_t blockCapacity() noexcept { return B; }
+
+    // Same contracts as the SkipList members of the same names.
+    bool insert(const K& key, const V& value);
+    [[nodiscard]] V& find(const K& key);
+    [[nodiscard]] const V& find(const K& key) const;
+    [[nodiscard]] bool contains(const K& key) const;
+    [[nodiscard]] const K& nextKey(const K& key) const;
+    [[nodiscard]] const K& previousKey(const K& key) const;
+    [[nodiscard]] std::vector<K> allKeysInOrder() const;
+    void erase(const K& key);
+
+    [[nodiscard]] const_iterator begin() const;
+    [[nodiscard]] const_iterator end() const { return {}; }
+    [[nodiscard]] const_iterator lower_bound(const K& key) const;
+
+    // Call fn(key, value) for every key in [lo, hi), in order.
+    template <typename F>
+    void forEachInRange(const K& lo, const K& hi, F fn) const;
+};
+
+template <typename K, typename V, size_t B>
+UnrolledSkipList<K, V, B>::~UnrolledSkipList() {
+    for (IndexNode* head : heads) {
+        IndexNode* node{head};
+        while (node != nullptr) {
+            IndexNode* next{node->next};
+            delete node;
+            node = next;
+        }
+    }
+    Block* block{first};
+    while (block != nullptr) {
+        Block* next{block->next};
+        delete block;
+        block = next;
+    }
+}
+
+template <typename K, typename V, size_t B>
+typename UnrolledSkipList<K, V, B>::Block* UnrolledSkipList<K, V, B>::findBlock(
+    const K& key, IndexNode** path) const {
+    // Returns the last block whose first key is not greater than key, or
+    // the first block if there is none. path[i], if asked for, is the last
+    // node on index layer i + 1 whose key is not greater than key.
+    IndexNode* node{nullptr};
+    for (size_t layer = heads.size(); layer-- > 0;) {
+        node = node == nullptr ? heads[layer] : node->down;
+        while (node->next != nullptr and not(key < node->next->key)) {
+            node = node->next;
+        }
+        if (path != nullptr) {
+            path[layer] = node;
+        }
+    }
+
+    Block* block{node == nullptr ? first : node->block};
+    while (block->next != nullptr and not(key < block->next->keys[0])) {
+        block = block->next;
+    }
+    return block;
+}
+
+template <typename K, typename V, size_t B>
+size_t UnrolledSkipList<K, V, B>::position(const Block* block, const K& key) {
+    return countLess(block->keys.data(), block->count, key);
+}
+
+template <typename K, typename V, size_t B>
+bool UnrolledSkipList<K, V, B>::insert(const K& key, const V& value) {
+    IndexNode* path[MAX_INDEX_LAYERS];
+    Block* block{findBlock(key, path)};
+    size_t index{position(block, key)};
+    if (index < block->count and block->keys[index] == key) {
+        return false;
+    }
+
+    if (block->count == B) {
+        splitBlock(block, path);
+        if (index > block->count) {
+            index -= block->count;
+            block = block->next;
+        }
+    }
+
+    std::move_backward(block->keys.begin() + index, block->keys.begin() + block->count,
+                       block->keys.begin() + block->count + 1);
+    std::move_backward(block->values.begin() + index,
+                       block->values.begin() + block->count,
+                       block->values.begin() + block->count + 1);
+    block->keys[index] = key;
+    block->values[index] = value;
+    block->count++;
+    entries++;
+    return true;
+}
+
+template <typename K, typename V, size_t B>
+void UnrolledSkipList<K, V, B>::splitBlock(Block* block, IndexNode** path) {
+    // The upper half moves to a new block right after this one. Every
+    // path node is at or before this block's tower and its successor is
+    // past this block, so the new tower goes right after it.
+    auto* right = new Block;
+    const size_t half{B / 2};
+    std::move(block->keys.begin() + half, block->keys.end(), right->keys.begin());
+    std::move(block->values.begin() + half, block->values.end(), right->values.begin());
+    right->count = B - half;
+    block->count = half;
+
+    right->next = block->next;
+    right->previous = block;
+    if (block->next != nullptr) {
+        block->next->previous = right;
+    }
+    block->next = right;
+    blocks++;
+
+    IndexNode* below{nullptr};
+    for (size_t layer = 0; layer < MAX_INDEX_LAYERS and (coin() & 1) != 0; layer++) {
+        if (layer == heads.size()) {
+            IndexNode* headBelow{layer == 0 ? nullptr : heads[layer - 1]};
+            heads.push_back(new IndexNode{K{}, nullptr, headBelow, first});
+            path[layer] = heads[layer];
+        }
+        auto* node = new IndexNode{right->keys[0], path[layer]->next, below, right};
+        path[layer]->next = node;
+        below = node;
+    }
+    right->tower = below;
+}
+
+template <typename K, typename V, size_t B>
+void UnrolledSkipList<K, V, B>::erase(const K& key) {
+    Block* block{findBlock(key)};
+    size_t index{position(block, key)};
+    if (index == block->count or not(block->keys[index] == key)) {
+        throw std::out_of_range("Key is not in the UnrolledSkipList");
+    }
+
+    std::move(block->keys.begin() + index + 1, block->keys.begin() + block->count,
+              block->keys.begin() + index);
+    std::move(block->values.begin() + index + 1, block->values.begin() + block->count,
+              block->values.begin() + index);
+    block->count--;
+    // Release whatever the vacated slot still owns
+    block->keys[block->count] = K{};
+    block->values[block->count] = V{};
+    entries--;
+    rebalance(block);
+}
+
+template <typename K, typename V, size_t B>
+void UnrolledSkipList<K, V, B>::rebalance(Block* block) {
+    if (block->count < MIN_ENTRIES) {
+        Block* right{block->next};
+        if (right != nullptr and block->count + right->count <= B) {
+            removeTower(right);
+            std::move(right->keys.begin(), right->keys.begin() + right->count,
+                      block->keys.begin() + block->count);
+            std::move(right->values.begin(), right->values.begin() + right->count,
+                      block->values.begin() + block->count);
+            block->count += right->count;
+            unlinkBlock(right);
+        } else if (block != first and block->count + block->previous->count <= B) {
+            Block* left{block->previous};
+            removeTower(block);
+            std::move(block->keys.begin(), block->keys.begin() + block->count,
+                      left->keys.begin() + left->count);
+            std::move(block->values.begin(), block->values.begin() + block->count,
+                      left->values.begin() + left->count);
+            left->count += block->count;
+            unlinkBlock(block);
+            return;
+        }
+    }
+
+    // The erase (or merge) may have changed the block's first key
+    if (block != first) {
+        updateTowerKey(block);
+    }
+}
+
+template <typename K, typename V, size_t B>
+void UnrolledSkipList<K, V, B>::updateTowerKey(Block* block) {
+    for (IndexNode* node = block->tower; node != nullptr; node = node->down) {
+        node->key = block->keys[0];
+    }
+}
+
+template <typename K, typename V, size_t B>
+void UnrolledSkipList<K, V, B>::removeTower(Block* block) {
+    if (block->tower == nullptr) {
+        return;
+    }
+    const K key{block->tower->key};
+    IndexNode* node{nullptr};
+    for (size_t layer = heads.size(); layer-- > 0;) {
+        node = node == nullptr ? heads[layer] : node->down;
+        while (node->next != nullptr and node->next->key < key) {
+            node = node->next;
+        }
+        if (node->next != nullptr and node->next->block == block) {
+            IndexNode* removed{node->next};
+            node->next = removed->next;
+            delete removed;
+        }
+    }
+    block->tower = nullptr;
+}
+
+template <typename K, typename V, size_t B>
+void UnrolledSkipList<K, V, B>::unlinkBlock(Block* block) {
+    block->previous->next = block->next;
+    if (block->next != nullptr) {
+        block->next->previous = block->previous;
+    }
+    delete block;
+    blocks--;
+}
+
+template <typename K, typename V, size_t B>
+V& UnrolledSkipList<K, V, B>::find(const K& key) {
+    return const_cast<V&>(std::as_const(*this).find(key));
+}
+
+template <typename K, typename V, size_t B>
+const V& UnrolledSkipList<K, V, B>::find(const K& key) const {
+    const Block* block{findBlock(key)};
+    size_t index{position(block, key)};
+    if (index == block->count or not(block->keys[index] == key)) {
+        throw std::out_of_range("Key is not in the UnrolledSkipList");
+    }
+    return block->values[index];
+}
+
+template <typename K, typename V, size_t B>
+bool UnrolledSkipList<K, V, B>::contains(const K& key) const {
+    const Block* block{findBlock(key)};
+    size_t index{position(block, key)};
+    return index < block->count and block->keys[index] == key;
+}
+
+template <typename K, typename V, size_t B>
+const K& UnrolledSkipList<K, V, B>::nextKey(const K& key) const {
+    const Block* block{findBlock(key)};
+    size_t index{position(block, key)};
+    if (index == block->count or not(block->keys[index] == key)) {
+        throw std::out_of_range("Key is not in the UnrolledSkipList");
+    }
+    if (index + 1 < block->count) {
+        return block->keys[index + 1];
+    }
+    if (block->next == nullptr) {
+        throw std::out_of_range("Key is the largest in the UnrolledSkipList");
+    }
+    return block->next->keys[0];
+}
+
+template <typename K, typename V, size_t B>
+const K& UnrolledSkipList<K, V, B>::previousKey(const K& key) const {
+    const Block* block{findBlock(key)};
+    size_t index{position(block, key)};
+    if (index == block->count or not(block->keys[index] == key)) {
+        throw std::out_of_range("Key is not in the UnrolledSkipList");
+    }
+    if (index > 0) {
+        return block->keys[index - 1];
+    }
+    if (block->previous == nullptr) {
+        throw std::out_of_range("Key is the smallest in the UnrolledSkipList");
+    }
+    return block->previous->keys[block->previous->count - 1];
+}
+
+template <typename K, typename V, size_t B>
+std::vector<K> UnrolledSkipList<K, V, B>::allKeysInOrder() const {
+    std::vector<K> keys;
+    keys.reserve(entries);
+    for (const Block* block = first; block != nullptr; block = block->next) {
+        keys.insert(keys.end(), block->keys.begin(), block->keys.begin() + block->count);
+    }
+    return keys;
+}
+
+template <typename K, typename V, size_t B>
+typename UnrolledSkipList<K, V, B>::const_iterator UnrolledSkipList<K, V, B>::begin()
+    const {
+    return entries == 0 ? end() : const_iterator{first, 0};
+}
+
+template <typename K, typename V, size_t B>
+typename UnrolledSkipList<K, V, B>::const_iterator UnrolledSkipList<K, V, B>::lower_bound(
+    const K& key) const {
+    const Block* block{findBlock(key)};
+    size_t index{position(block, key)};
+    if (index < block->count) {
+        return {block, index};
+    }
+    return block->next == nullptr ? end() : const_iterator{block->next, 0};
+}
+
+template <typename K, typename V, size_t B>
+template <typename F>
+void UnrolledSkipList<K, V, B>::forEachInRange(const K& lo, const K& hi, F fn) const {
+    for (auto it = lower_bound(lo); it != end(); ++it) {
+        auto [key, value] = *it;
+        if (not(key < hi)) {
+            return;
+        }
+        fn(key, value);
+    }
+}
+
+}  // namespace shindler::ics46::project2
+#endif
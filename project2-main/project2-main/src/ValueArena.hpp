@@ -0,0 +1,89 @@
+#ifndef ___VALUE_ARENA_HPP
+#define ___VALUE_ARENA_HPP
+
+#include <cstddef>
+#include <utility>
+
+#include "NodePool.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Pool of V objects, for values too big to keep inside a SkipList
+ * node.
+ *
+ * A NodePool<V> that also counts the values alive in it. create()
+ * constructs a value in a free slot and destroy() destroys it and frees the
+ * slot for the next create(). Slots never move, and the arena must outlive
+ * every value it made (destroying the arena does not destroy the values).
+ *
+ * There is no lock: one thread at a time per arena. splice() moves every
+ * chunk of one arena into another, so SkipList::buildFromSorted gives each
+ * thread an arena of its own and hands them all to the list afterwards.
+ * take() moves a single value over by sharing its chunk, which is how a
+ * SkipList node handle carries the value of the tower it holds.
+ */
+template <typename V>
+class ValueArena {
+   public:
+    ValueArena() = default;
+    ValueArena(const ValueArena&) = delete;
+    ValueArena& operator=(const ValueArena&) = delete;
+
+    ValueArena(ValueArena&& other) noexcept
+        : pool{std::move(other.pool)}, live{std::exchange(other.live, 0)} {}
+
+    ValueArena& operator=(ValueArena&& other) noexcept {
+        pool = std::move(other.pool);
+        live = std::exchange(other.live, 0);
+        return *this;
+    }
+
+    template <typename... Args>
+    V* create(Args&&... args) {
+        V* value{pool.create(std::forward<Args>(args)...)};
+        live++;
+        return value;
+    }
+
+    void destroy(V* value) noexcept {
+        pool.destroy(value);
+        live--;
+    }
+
+    // Make *value*, which *other* made, this arena's to destroy. The chunk
+    // it is in is shared rather than the value moved.
+    void take(ValueArena& other, V* value) {
+        pool.share(other.pool, value);
+        other.live--;
+        live++;
+    }
+
+    // Take every chunk and free slot of *other*, leaving it empty. The
+    // values *other* made are then destroyed through this arena.
+    void splice(ValueArena& other) {
+        pool.splice(other.pool);
+        live += std::exchange(other.live, 0);
+    }
+
+    // Make sure at least *count* values can be created without the global
+    // allocator, and release chunks none of whose slots are in use
+    void reserve(size_t count) { pool.reserve(count); }
+    void shrinkToFit() { pool.shrinkToFit(); }
+
+    // Values that can be created before the arena needs another chunk
+    [[nodiscard]] size_t available() const noexcept { return pool.available(); }
+
+    // Values created and not yet destroyed
+    [[nodiscard]] size_t size() const noexcept { return live; }
+
+    // Bytes held in chunks, whether or not their slots are in use
+    [[nodiscard]] size_t capacityBytes() const noexcept { return pool.capacityBytes(); }
+
+   private:
+    NodePool<V> pool;
+    size_t live{0};
+};
+
+}  // namespace shindler::ics46::project2
+#endif
@@ -0,0 +1,120 @@
+#ifndef ___WORK_STEALING_HPP
+#define ___WORK_STEALING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief Runs tasks `0 .. tasks - 1` on up to `threads` threads and returns
+ * once every task has finished.
+ *
+ * Every thread starts with its own contiguous block of task indices and works
+ * through it front to back, so neighbouring tasks stay on the same core. A
+ * thread that runs out of work steals from the back of another thread's
+ * queue, which keeps all threads busy when some tasks take longer than
+ * others. The calling thread works as thread 0.
+ *
+ * If a task throws, the remaining tasks still run and the first exception is
+ * rethrown on the calling thread.
+ *
+ * @param tasks number of tasks to run
+ * @param threads maximum number of threads to use, 0 picks one per core
+ * @param task callable invoked as `task(index)`
+ */
+template <typename Task>
+void runWorkStealing(size_t tasks, size_t threads, Task&& task) {
+    struct TaskQueue {
+        std::mutex lock;
+        std::deque<size_t> indices;
+    };
+
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, tasks);
+    if (threads <= 1) {
+        for (size_t index = 0; index < tasks; index++) {
+            task(index);
+        }
+        return;
+    }
+
+    std::vector<TaskQueue> queues(threads);
+    for (size_t t = 0; t < threads; t++) {
+        for (size_t index = tasks * t / threads;
+             index < tasks * (t + 1) / threads; index++) {
+            queues[t].indices.push_back(index);
+        }
+    }
+
+    std::mutex errorLock;
+    std::exception_ptr firstError;
+
+    auto nextTask = [&](size_t self, size_t& index) {
+        {
+            std::lock_guard<std::mutex> guard{queues[self].lock};
+            if (not queues[self].indices.empty()) {
+                index = queues[self].indices.front();
+                queues[self].indices.pop_front();
+                return true;
+            }
+        }
+        // Tasks never spawn tasks, so once every queue has been seen empty
+        // there is nothing left to steal.
+        for (size_t offset = 1; offset < threads; offset++) {
+            TaskQueue& victim{queues[(self + offset) % threads]};
+            std::lock_guard<std::mutex> guard{victim.lock};
+            if (not victim.indices.empty()) {
+                index = victim.indices.back();
+                victim.indices.pop_back();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto work = [&](size_t self) {
+        size_t index{0};
+        while (nextTask(self, index)) {
+            try {
+                task(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard{errorLock};
+                if (not firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        // The threads that did start steal the tasks of those that could
+        // not, so the run goes on with fewer threads and still joins them
+        try {
+            workers.emplace_back(work, t);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    work(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+}  // namespace shindler::ics46::project2
+#endif
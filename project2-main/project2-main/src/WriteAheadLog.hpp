@@ -0,0 +1,270 @@
+#ifndef ___WRITE_AHEAD_LOG_HPP
+#define ___WRITE_AHEAD_LOG_HPP
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BinaryIO.hpp"
+
+namespace shindler::ics46::project2 {
+
+/**
+ * @brief When a WriteAheadLog pushes records to disk.
+ *
+ * Records are buffered in memory and written with one write() call per
+ * batch. A batch is written, and commit() waits for it, once
+ * *syncEveryRecords* records or *syncEveryBytes* bytes are waiting. With
+ * the defaults every commit is durable when it returns; raising
+ * *syncEveryRecords* trades a window of lost records on a crash for
+ * throughput, and sync() closes that window on demand.
+ */
+struct WalOptions {
+    size_t syncEveryRecords{1};
+    size_t syncEveryBytes{size_t{1} << 20};
+    // fdatasync after every batch. Without it a batch survives a process
+    // crash but not a power loss.
+    bool fsync{true};
+};
+
+/**
+ * @brief Append-only log of opaque records with group commit.
+ *
+ * Each record is framed as a 32-bit payload length, the low 32 bits of the
+ * payload's FNV-1a hash, and the payload, so replay can tell a torn final
+ * record from a complete one.
+ *
+ * append() only copies the record into the pending batch. commit() then
+ * waits for the batch holding the record: the first thread to get there
+ * becomes the leader and writes and syncs everything waiting, including
+ * records other threads appended in the meantime, while those threads
+ * wait for it instead of issuing their own fsync.
+ *
+ * A batch that fails to write may have left part of a record on disk,
+ * which replay stops at, so nothing appended after it can be made durable.
+ * The log fails for good then: the commit that hit the error, every commit
+ * waiting on it and every later append, commit, sync and reset throw.
+ */
+class WriteAheadLog {
+   public:
+    // Open *path* for appending, creating it if needed. Throw a
+    // std::runtime_error if it cannot be opened.
+    WriteAheadLog(const std::string& path, WalOptions options)
+        : path{path}, options{options} {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                    0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path + " for appending");
+        }
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog(WriteAheadLog&&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(WriteAheadLog&&) = delete;
+
+    // Writes out whatever is still pending; errors are ignored here, call
+    // sync() first to see them.
+    ~WriteAheadLog() {
+        try {
+            sync();
+        } catch (...) {
+        }
+        ::close(fd);
+    }
+
+    // Add one record to the pending batch and return its sequence number.
+    // Throw a std::runtime_error if the log has failed.
+    uint64_t append(const void* payload, size_t length) {
+        const auto* bytes = static_cast<const char*>(payload);
+        Fnv1a checksum;
+        checksum.update(bytes, length);
+        auto frameLength = static_cast<uint32_t>(length);
+        auto frameChecksum = static_cast<uint32_t>(checksum.digest());
+
+        std::lock_guard<std::mutex> guard{lock};
+        throwIfFailed();
+        BufferWriter writer{pending};
+        writer.writeValue(frameLength);
+        writer.writeValue(frameChecksum);
+        writer.write(bytes, length);
+        pendingRecords++;
+        return ++appendedSequence;
+    }
+
+    // Make record *sequence* as durable as the options ask for: return at
+    // once if it is still in a pending batch below the thresholds,
+    // otherwise wait until it has been written. A record a leader has
+    // already taken is always waited for. Throw a std::runtime_error if
+    // writing fails or the log has failed.
+    void commit(uint64_t sequence) {
+        std::unique_lock<std::mutex> guard{lock};
+        throwIfFailed();
+        if (sequence > takenSequence and pendingRecords < options.syncEveryRecords and
+            pending.size() < options.syncEveryBytes) {
+            return;
+        }
+        flushThrough(sequence, guard);
+    }
+
+    // Write and sync every record appended so far.
+    void sync() {
+        std::unique_lock<std::mutex> guard{lock};
+        flushThrough(appendedSequence, guard);
+    }
+
+    // Sequence number of the last record known to be written (and synced,
+    // if the options ask for it)
+    [[nodiscard]] uint64_t durableThrough() {
+        std::lock_guard<std::mutex> guard{lock};
+        return durableSequence;
+    }
+
+    // Drop every record, after a checkpoint has made them redundant.
+    void reset() {
+        std::unique_lock<std::mutex> guard{lock};
+        flushThrough(appendedSequence, guard);
+        if (::ftruncate(fd, 0) != 0) {
+            throw std::runtime_error("Cannot truncate " + path);
+        }
+    }
+
+    /**
+     * @brief Call apply(reader) with a BufferReader over every intact record
+     * in the log at *path*, in order, and return how many there were.
+     *
+     * The file is read in one go. Replay stops at the first record that is
+     * truncated or fails its checksum, which is what a crash in the middle
+     * of a write leaves behind, and the file is cut back to the last intact
+     * record so later appends follow it. A missing file replays nothing.
+     */
+    template <typename Apply>
+    static size_t replay(const std::string& path, Apply&& apply) {
+        std::ifstream in{path, std::ios::binary | std::ios::ate};
+        if (not in) {
+            return 0;
+        }
+        std::string contents(static_cast<size_t>(in.tellg()), '\0');
+        in.seekg(0);
+        in.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+        in.close();
+
+        const size_t FRAME_BYTES{2 * sizeof(uint32_t)};
+        size_t offset{0};
+        size_t records{0};
+        while (contents.size() - offset >= FRAME_BYTES) {
+            uint32_t length{0};
+            uint32_t storedChecksum{0};
+            std::memcpy(&length, contents.data() + offset, sizeof(length));
+            std::memcpy(&storedChecksum, contents.data() + offset + sizeof(length),
+                        sizeof(storedChecksum));
+            if (length > contents.size() - offset - FRAME_BYTES) {
+                break;
+            }
+            const char* payload{contents.data() + offset + FRAME_BYTES};
+            Fnv1a checksum;
+            checksum.update(payload, length);
+            if (static_cast<uint32_t>(checksum.digest()) != storedChecksum) {
+                break;
+            }
+
+            BufferReader reader{payload, length};
+            apply(reader);
+            offset += FRAME_BYTES + length;
+            records++;
+        }
+
+        if (offset != contents.size() and
+            ::truncate(path.c_str(), static_cast<off_t>(offset)) != 0) {
+            throw std::runtime_error("Cannot drop the torn tail of " + path);
+        }
+        return records;
+    }
+
+   private:
+    std::string path;
+    WalOptions options;
+    int fd{-1};
+
+    std::mutex lock;
+    std::condition_variable batchWritten;
+    std::string pending;
+    size_t pendingRecords{0};
+    uint64_t appendedSequence{0};
+    // Records up to here have been taken out of pending by a leader
+    uint64_t takenSequence{0};
+    uint64_t durableSequence{0};
+    bool writing{false};
+    // A batch failed to write; nothing later can be made durable
+    bool failed{false};
+
+    void throwIfFailed() const {
+        if (failed) {
+            throw std::runtime_error("Earlier write to " + path + " failed");
+        }
+    }
+
+    // Write batches until *sequence* is durable, either as the leader or by
+    // waiting for the current leader.
+    void flushThrough(uint64_t sequence, std::unique_lock<std::mutex>& guard) {
+        throwIfFailed();
+        while (durableSequence < sequence) {
+            if (writing) {
+                batchWritten.wait(guard);
+                throwIfFailed();
+                continue;
+            }
+
+            std::string batch;
+            batch.swap(pending);
+            pendingRecords = 0;
+            const uint64_t batchSequence{appendedSequence};
+            takenSequence = batchSequence;
+            writing = true;
+
+            guard.unlock();
+            bool written{writeBatch(batch)};
+            guard.lock();
+
+            writing = false;
+            if (written) {
+                durableSequence = batchSequence;
+            } else {
+                failed = true;
+            }
+            batchWritten.notify_all();
+            if (not written) {
+                throw std::runtime_error("Failed writing " + path);
+            }
+        }
+    }
+
+    bool writeBatch(const std::string& batch) const {
+        size_t offset{0};
+        while (offset < batch.size()) {
+            ssize_t written{::write(fd, batch.data() + offset, batch.size() - offset)};
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        return not options.fsync or ::fdatasync(fd) == 0;
+    }
+};
+
+}  // namespace shindler::ics46::project2
+#endif
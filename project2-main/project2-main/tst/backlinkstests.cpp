@@ -0,0 +1,103 @@
+#include <SkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+struct BaseOnlyTraits : proj2::SkipListTraits {
+    static constexpr proj2::BackLinks BACK_LINKS{proj2::BackLinks::BaseOnly};
+};
+
+struct NoBackLinksTraits : proj2::SkipListTraits {
+    static constexpr proj2::BackLinks BACK_LINKS{proj2::BackLinks::None};
+};
+
+struct CountingNoBackLinksTraits : proj2::CountingSkipListTraits {
+    static constexpr proj2::BackLinks BACK_LINKS{proj2::BackLinks::None};
+};
+
+// Random inserts and erases, checked against std::map and against a list
+// with every back link, which must build the same towers
+template <typename Traits>
+void requireSameAsClassicList() {
+    proj2::SkipList<unsigned, unsigned, Traits> skipList;
+    proj2::SkipList<unsigned, unsigned> classic;
+    std::map<unsigned, unsigned> reference;
+    std::mt19937 random{46};
+
+    for (int step = 0; step < 10000; step++) {
+        auto key = static_cast<unsigned>(random() % 1000);
+        if (random() % 3 == 0 and reference.count(key) != 0) {
+            skipList.erase(key);
+            classic.erase(key);
+            reference.erase(key);
+        } else {
+            auto value = static_cast<unsigned>(step);
+            REQUIRE(skipList.insert(key, value) == reference.emplace(key, value).second);
+            classic.insert(key, value);
+        }
+    }
+
+    REQUIRE(skipList.size() == reference.size());
+    REQUIRE(skipList.layers() == classic.layers());
+    unsigned previous{0};
+    bool first{true};
+    for (const auto& [key, value] : reference) {
+        REQUIRE(skipList.find(key) == value);
+        REQUIRE(skipList.height(key) == classic.height(key));
+        if (first) {
+            REQUIRE(skipList.isSmallestKey(key));
+            REQUIRE_THROWS(skipList.previousKey(key));
+        } else {
+            REQUIRE(skipList.previousKey(key) == previous);
+        }
+        REQUIRE(skipList.isLargestKey(key) == (key == reference.rbegin()->first));
+        previous = key;
+        first = false;
+    }
+    REQUIRE_THROWS_AS(skipList.previousKey(1000), std::out_of_range);
+    REQUIRE_THROWS_AS(skipList.erase(1000), std::out_of_range);
+}
+
+TEST_CASE("SkipList:BackLinksBaseOnly:ExpectSameAsClassicList", "[SkipList][BackLinks]") {
+    requireSameAsClassicList<BaseOnlyTraits>();
+}
+
+TEST_CASE("SkipList:BackLinksNone:ExpectSameAsClassicList", "[SkipList][BackLinks]") {
+    requireSameAsClassicList<NoBackLinksTraits>();
+}
+
+TEST_CASE("SkipList:BackLinksNone:ExpectSmallerNodes", "[SkipList][BackLinks]") {
+    proj2::SkipList<unsigned, unsigned> classic;
+    proj2::SkipList<unsigned, unsigned, NoBackLinksTraits> forward;
+    for (unsigned i = 0; i < 100; i++) {
+        classic.insert(i, i);
+        forward.insert(i, i);
+    }
+    const proj2::SkipListReport classicReport{classic.structureReport()};
+    const proj2::SkipListReport forwardReport{forward.structureReport()};
+    REQUIRE(forwardReport.nodeCount == classicReport.nodeCount);
+    REQUIRE(forwardReport.nodeBytes + sizeof(void*) * forwardReport.nodeCount ==
+            classicReport.nodeBytes);
+}
+
+TEST_CASE("SkipList:BackLinksNoneErase:ExpectOneSearchPerErase", "[SkipList][BackLinks]") {
+    proj2::SkipList<std::string, unsigned, CountingNoBackLinksTraits> skipList;
+    for (unsigned i = 0; i < 200; i++) {
+        skipList.insert("key" + std::to_string(i), i);
+    }
+    const size_t height{skipList.height("key42")};
+    skipList.resetStats();
+
+    skipList.erase("key42");
+    REQUIRE(skipList.stats().downHops == skipList.layers() - 1);
+    REQUIRE(skipList.stats().nodesFreed == height);
+    REQUIRE_FALSE(skipList.contains("key42"));
+    REQUIRE(skipList.nextKey("key41") == "key43");
+}
+
+}  // namespace
@@ -0,0 +1,89 @@
+#include <SkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+TEST_CASE("SkipList:BulkBuild:ExpectSameShapeAsSequentialInserts",
+          "[SkipList][BulkBuild]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 20000;
+    const unsigned int VALUE_OFFSET = 100;
+    const size_t THREADS = 4;
+
+    proj2::SkipList<unsigned, unsigned> sequential;
+    proj2::SkipList<unsigned, unsigned> parallel;
+    std::vector<std::pair<unsigned, unsigned>> entries;
+
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        sequential.insert(i, i + VALUE_OFFSET);
+        entries.emplace_back(i, i + VALUE_OFFSET);
+    }
+    parallel.buildFromSorted(entries, THREADS);
+
+    REQUIRE(parallel.size() == sequential.size());
+    REQUIRE(parallel.layers() == sequential.layers());
+    REQUIRE(parallel.allKeysInOrder() == sequential.allKeysInOrder());
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(parallel.height(i) == sequential.height(i));
+        REQUIRE(parallel.find(i) == i + VALUE_OFFSET);
+    }
+    REQUIRE(parallel.isSmallestKey(0));
+    REQUIRE(parallel.isLargestKey(NUMBER_OF_ELEMENTS - 1));
+    REQUIRE(parallel.previousKey(NUMBER_OF_ELEMENTS - 1) ==
+            NUMBER_OF_ELEMENTS - 2);
+
+    // The built list keeps accepting inserts like any other
+    parallel.insert(NUMBER_OF_ELEMENTS, 0);
+    sequential.insert(NUMBER_OF_ELEMENTS, 0);
+    REQUIRE(parallel.height(NUMBER_OF_ELEMENTS) ==
+            sequential.height(NUMBER_OF_ELEMENTS));
+}
+
+TEST_CASE("SkipList:BulkBuildSmallList:ExpectLayerCapRespected",
+          "[SkipList][BulkBuild]") {
+    const unsigned MAGIC_VAL = 255;
+
+    proj2::SkipList<unsigned, unsigned> sequential;
+    proj2::SkipList<unsigned, unsigned> parallel;
+    std::vector<std::pair<unsigned, unsigned>> entries;
+
+    for (unsigned i = 0; i < 10; i++) {
+        sequential.insert(i, i);
+        entries.emplace_back(i, i);
+    }
+    sequential.insert(MAGIC_VAL, MAGIC_VAL);
+    entries.emplace_back(MAGIC_VAL, MAGIC_VAL);
+    parallel.buildFromSorted(entries);
+
+    REQUIRE(parallel.height(MAGIC_VAL) == 12);
+    REQUIRE(parallel.layers() == 13);
+    REQUIRE(parallel.layers() == sequential.layers());
+}
+
+TEST_CASE("SkipList:BulkBuildStrings:ExpectFoundValues",
+          "[SkipList][BulkBuild]") {
+    proj2::SkipList<std::string, std::string> skipList;
+
+    skipList.buildFromSorted({{"BA", "SCHOOL"}, {"TA", "OFFICEHOURS"}});
+
+    REQUIRE(skipList.find("BA") == "SCHOOL");
+    REQUIRE(skipList.nextKey("BA") == "TA");
+    REQUIRE(skipList.layers() == 4);
+}
+
+TEST_CASE("SkipList:BulkBuildUnsortedOrNonEmpty:ExpectThrows",
+          "[SkipList][BulkBuild]") {
+    proj2::SkipList<unsigned, unsigned> skipList;
+
+    REQUIRE_THROWS_AS(skipList.buildFromSorted({{2, 2}, {1, 1}}),
+                      std::invalid_argument);
+    REQUIRE(skipList.empty());
+
+    skipList.insert(1, 1);
+    REQUIRE_THROWS_AS(skipList.buildFromSorted({{2, 2}}), std::logic_error);
+}
+
+}  // namespace
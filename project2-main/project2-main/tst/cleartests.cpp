@@ -0,0 +1,96 @@
+#include <SkipList.hpp>
+#include <array>
+#include <catch2/catch_amalgamated.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+template <size_t BYTES>
+struct Tracked {
+    static inline long alive{0};
+    std::array<char, BYTES> bytes{};
+    unsigned id;
+
+    explicit Tracked(unsigned id) : id{id} { alive++; }
+    Tracked(const Tracked& other) : bytes{other.bytes}, id{other.id} { alive++; }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked() { alive--; }
+};
+
+TEST_CASE("SkipList:Clear:ExpectEmptyAndStorageReused", "[SkipList][Clear]") {
+    proj2::SkipList<unsigned, unsigned, proj2::CountingSkipListTraits> skipList;
+    for (unsigned key = 0; key < 5000; key++) {
+        skipList.insert(key, key);
+    }
+    size_t layers{skipList.layers()};
+
+    skipList.clear();
+    REQUIRE(skipList.empty());
+    REQUIRE(skipList.begin() == skipList.end());
+    REQUIRE(skipList.layers() == layers);
+    REQUIRE_FALSE(skipList.contains(42));
+
+    // The same keys fit in the storage the old ones left behind
+    skipList.resetStats();
+    size_t free{skipList.reservedNodes()};
+    for (unsigned key = 0; key < 5000; key++) {
+        REQUIRE(skipList.insert(key, key + 1));
+    }
+    REQUIRE(skipList.stats().nodesAllocated == free - skipList.reservedNodes());
+    REQUIRE(skipList.find(4999) == 5000);
+    REQUIRE(skipList.isSmallestKey(0));
+}
+
+TEST_CASE("SkipList:ClearAndTeardown:ExpectEveryValueDestroyedOnce", "[SkipList][Clear]") {
+    using Small = Tracked<8>;
+    using Large = Tracked<512>;
+    {
+        proj2::SkipList<std::string, Small> inline_;
+        proj2::SkipList<std::string, Large> outOfLine;
+        for (unsigned i = 0; i < 300; i++) {
+            inline_.insert(std::to_string(i), Small{i});
+            outOfLine.insert(std::to_string(i), Large{i});
+        }
+        REQUIRE(Small::alive == 300);
+        REQUIRE(Large::alive == 300);
+
+        inline_.clear();
+        outOfLine.clear();
+        REQUIRE(Small::alive == 0);
+        REQUIRE(Large::alive == 0);
+
+        for (unsigned i = 0; i < 100; i++) {
+            inline_.insert(std::to_string(i), Small{i});
+            outOfLine.insert(std::to_string(i), Large{i});
+        }
+        REQUIRE(outOfLine.find("42").id == 42);
+    }
+    // The destructors, which free the nodes a chunk at a time
+    REQUIRE(Small::alive == 0);
+    REQUIRE(Large::alive == 0);
+}
+
+TEST_CASE("SkipList:ClearWithExtractedTower:ExpectTowerKept", "[SkipList][Clear]") {
+    proj2::SkipList<unsigned, std::string> skipList;
+    for (unsigned key = 0; key < 200; key++) {
+        skipList.insert(key, std::to_string(key));
+    }
+    auto node = skipList.extract(7);
+
+    skipList.clear();
+    for (unsigned key = 1000; key < 1200; key++) {
+        skipList.insert(key, std::to_string(key));
+    }
+    REQUIRE(node.key() == 7);
+    REQUIRE(node.mapped() == "7");
+    REQUIRE(skipList.insert(std::move(node)).inserted);
+
+    REQUIRE(skipList.size() == 201);
+    REQUIRE(skipList.find(7) == "7");
+    REQUIRE(skipList.nextKey(7) == 1000);
+    REQUIRE(skipList.find(1100) == "1100");
+}
+
+}  // namespace
@@ -0,0 +1,91 @@
+#include <CompactSkipList.hpp>
+#include <SkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+TEST_CASE("CompactSkipList:Insert:ExpectSameTowersAsSkipList", "[CompactSkipList]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 2000;
+    proj2::CompactSkipList<unsigned, unsigned> compact;
+    proj2::SkipList<unsigned, unsigned> skipList;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(compact.insert(i * 7 % NUMBER_OF_ELEMENTS, i));
+        skipList.insert(i * 7 % NUMBER_OF_ELEMENTS, i);
+    }
+    REQUIRE_FALSE(compact.insert(3, 3));
+
+    REQUIRE(compact.size() == skipList.size());
+    REQUIRE(compact.layers() == skipList.layers());
+    REQUIRE(compact.allKeysInOrder() == skipList.allKeysInOrder());
+    size_t towerNodes{0};
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(compact.height(i) == skipList.height(i));
+        REQUIRE(compact.find(i) == skipList.find(i));
+        towerNodes += compact.height(i);
+    }
+    REQUIRE(compact.poolSize() == towerNodes + 2 * compact.layers());
+
+    REQUIRE(compact.nextKey(10) == 11);
+    REQUIRE(compact.previousKey(10) == 9);
+    REQUIRE_THROWS_AS(compact.nextKey(NUMBER_OF_ELEMENTS - 1), std::out_of_range);
+    REQUIRE_THROWS_AS(compact.previousKey(0), std::out_of_range);
+    REQUIRE_THROWS_AS(compact.find(NUMBER_OF_ELEMENTS), std::out_of_range);
+}
+
+TEST_CASE("CompactSkipList:RandomOperations:ExpectSameAsStdMap", "[CompactSkipList]") {
+    proj2::CompactSkipList<unsigned, unsigned> skipList;
+    std::map<unsigned, unsigned> reference;
+    std::mt19937 random{46};
+
+    for (int step = 0; step < 20000; step++) {
+        auto key = static_cast<unsigned>(random() % 1000);
+        if (random() % 3 == 0 and reference.count(key) != 0) {
+            skipList.erase(key);
+            reference.erase(key);
+        } else {
+            REQUIRE(skipList.insert(key, step) == reference.emplace(key, step).second);
+        }
+    }
+
+    REQUIRE(skipList.size() == reference.size());
+    auto it = skipList.begin();
+    for (const auto& [key, value] : reference) {
+        REQUIRE((*it).first == key);
+        REQUIRE((*it).second == value);
+        REQUIRE(skipList.contains(key));
+        ++it;
+    }
+    REQUIRE(it == skipList.end());
+    REQUIRE((*skipList.lower_bound(500)).first == reference.lower_bound(500)->first);
+}
+
+TEST_CASE("CompactSkipList:EraseThenInsert:ExpectFreedNodesReused", "[CompactSkipList]") {
+    proj2::CompactSkipList<std::string, unsigned> skipList;
+    for (unsigned i = 0; i < 500; i++) {
+        skipList.insert("key" + std::to_string(i), i);
+    }
+    const size_t poolSize{skipList.poolSize()};
+    REQUIRE(skipList.freeNodes() == 0);
+
+    for (unsigned i = 0; i < 500; i++) {
+        skipList.erase("key" + std::to_string(i));
+    }
+    REQUIRE(skipList.empty());
+    REQUIRE(skipList.begin() == skipList.end());
+    REQUIRE(skipList.freeNodes() + 2 * skipList.layers() == poolSize);
+
+    // Same keys, same towers: every node comes off the free list
+    for (unsigned i = 0; i < 500; i++) {
+        skipList.insert("key" + std::to_string(i), i);
+    }
+    REQUIRE(skipList.poolSize() == poolSize);
+    REQUIRE(skipList.freeNodes() == 0);
+    REQUIRE(skipList.find("key250") == 250);
+}
+
+}  // namespace
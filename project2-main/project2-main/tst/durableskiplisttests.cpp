@@ -0,0 +1,247 @@
+#include <DurableSkipList.hpp>
+#include <WriteAheadLog.hpp>
+#include <atomic>
+#include <catch2/catch_amalgamated.hpp>
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+std::string logPath(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + ".snapshot");
+    return path.string();
+}
+
+TEST_CASE("DurableSkipList:ReopenAfterInsertsAndErases:ExpectSameContents",
+          "[DurableSkipList]") {
+    const std::string PATH = logPath("durable_reopen.wal");
+
+    {
+        proj2::DurableSkipList<unsigned, std::string> durable{PATH};
+        for (unsigned i = 0; i < 100; i++) {
+            REQUIRE(durable.insert(i, std::to_string(i)));
+        }
+        REQUIRE_FALSE(durable.insert(5, "again"));
+        for (unsigned i = 0; i < 100; i += 3) {
+            durable.erase(i);
+        }
+        REQUIRE_THROWS(durable.erase(0));
+    }
+
+    proj2::DurableSkipList<unsigned, std::string> reopened{PATH};
+    REQUIRE(reopened.recoveredRecords() == 134);
+    REQUIRE(reopened.skipList().size() == 66);
+    REQUIRE(reopened.skipList().find(5) == "5");
+    REQUIRE_FALSE(reopened.skipList().contains(3));
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("DurableSkipList:TornLastRecord:ExpectPrefixRecovered",
+          "[DurableSkipList]") {
+    const std::string PATH = logPath("durable_torn.wal");
+
+    {
+        proj2::DurableSkipList<std::string, std::string> durable{PATH};
+        durable.insert("Shindler", "ICS 46");
+        durable.insert("TA", "OFFICEHOURS");
+    }
+    std::filesystem::resize_file(PATH, std::filesystem::file_size(PATH) - 3);
+
+    {
+        proj2::DurableSkipList<std::string, std::string> recovered{PATH};
+        REQUIRE(recovered.recoveredRecords() == 1);
+        REQUIRE(recovered.skipList().find("Shindler") == "ICS 46");
+        REQUIRE_FALSE(recovered.skipList().contains("TA"));
+
+        // New records go after the last intact one
+        recovered.insert("BA", "SCHOOL");
+    }
+
+    proj2::DurableSkipList<std::string, std::string> reopened{PATH};
+    REQUIRE(reopened.recoveredRecords() == 2);
+    REQUIRE(reopened.skipList().allKeysInOrder() ==
+            std::vector<std::string>{"BA", "Shindler"});
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("DurableSkipList:CheckpointThenMoreWrites:ExpectSnapshotPlusLog",
+          "[DurableSkipList]") {
+    const std::string PATH = logPath("durable_checkpoint.wal");
+    proj2::WalOptions batched;
+    batched.syncEveryRecords = 64;
+    batched.fsync = false;
+
+    {
+        proj2::DurableSkipList<unsigned, unsigned> durable{PATH, batched};
+        for (unsigned i = 0; i < 1000; i++) {
+            durable.insert(i, i);
+        }
+        durable.checkpoint();
+        REQUIRE(std::filesystem::file_size(PATH) == 0);
+        durable.erase(10);
+        durable.insert(1000, 1000);
+        durable.sync();
+    }
+
+    proj2::DurableSkipList<unsigned, unsigned> reopened{PATH, batched};
+    REQUIRE(reopened.recoveredRecords() == 2);
+    REQUIRE(reopened.skipList().size() == 1000);
+    REQUIRE_FALSE(reopened.skipList().contains(10));
+    REQUIRE(reopened.skipList().find(1000) == 1000);
+    std::filesystem::remove(PATH);
+    std::filesystem::remove(PATH + ".snapshot");
+}
+
+TEST_CASE("DurableSkipList:ConcurrentWriters:ExpectEveryInsertRecovered",
+          "[DurableSkipList]") {
+    const std::string PATH = logPath("durable_concurrent.wal");
+    const unsigned THREADS = 4;
+    const unsigned PER_THREAD = 250;
+
+    {
+        proj2::DurableSkipList<unsigned, unsigned> durable{PATH};
+        std::vector<std::thread> writers;
+        for (unsigned t = 0; t < THREADS; t++) {
+            writers.emplace_back([&durable, t]() {
+                for (unsigned i = 0; i < PER_THREAD; i++) {
+                    durable.insert(t * PER_THREAD + i, t);
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+    }
+
+    proj2::DurableSkipList<unsigned, unsigned> reopened{PATH};
+    REQUIRE(reopened.skipList().size() == THREADS * PER_THREAD);
+    REQUIRE(reopened.skipList().find(PER_THREAD * 2) == 2);
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("WriteAheadLog:ConcurrentCommits:ExpectDurableWhenCommitReturns",
+          "[DurableSkipList]") {
+    const std::string PATH = logPath("wal_group_commit.wal");
+    const unsigned THREADS = 4;
+    const unsigned PER_THREAD = 200;
+
+    // Commits that return while a leader is still writing their record
+    std::atomic<unsigned> early{0};
+    {
+        proj2::WriteAheadLog log{PATH, proj2::WalOptions{}};
+        std::vector<std::thread> writers;
+        for (unsigned t = 0; t < THREADS; t++) {
+            writers.emplace_back([&log, &early, t]() {
+                for (unsigned i = 0; i < PER_THREAD; i++) {
+                    const unsigned payload{t * PER_THREAD + i};
+                    const auto sequence = log.append(&payload, sizeof(payload));
+                    // Let another writer's commit take this record first
+                    std::this_thread::yield();
+                    log.commit(sequence);
+                    if (log.durableThrough() < sequence) {
+                        early++;
+                    }
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+    }
+    REQUIRE(early == 0);
+
+    size_t records{proj2::WriteAheadLog::replay(PATH, [](proj2::BufferReader&) {})};
+    REQUIRE(records == THREADS * PER_THREAD);
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("DurableSkipList:LogFails:ExpectLostChangesUndone", "[DurableSkipList]") {
+    // The log is /dev/full, where every write fails, behind a symlink so
+    // the snapshot can sit next to it
+    const std::string PATH = logPath("durable_full.wal");
+    std::filesystem::create_symlink("/dev/full", PATH);
+    {
+        proj2::SkipList<unsigned, std::string> initial;
+        for (unsigned i = 0; i < 10; i++) {
+            initial.insert(i, std::to_string(i));
+        }
+        initial.save(PATH + ".snapshot");
+    }
+
+    // Two changes wait in the pending batch until the third writes it
+    proj2::DurableSkipList<unsigned, std::string> durable{
+        PATH, proj2::WalOptions{3, size_t{1} << 20, false}};
+    REQUIRE(durable.skipList().size() == 10);
+    REQUIRE(durable.insert(20, "twenty"));
+    durable.erase(5);
+    REQUIRE_THROWS_AS(durable.insert(21, "twenty-one"), std::runtime_error);
+
+    REQUIRE(durable.skipList().size() == 10);
+    REQUIRE_FALSE(durable.skipList().contains(20));
+    REQUIRE_FALSE(durable.skipList().contains(21));
+    REQUIRE(durable.skipList().find(5) == "5");
+    REQUIRE_THROWS_AS(durable.erase(6), std::runtime_error);
+    REQUIRE(durable.skipList().find(6) == "6");
+    REQUIRE_THROWS_AS(durable.erase(30), std::out_of_range);
+    REQUIRE_THROWS_AS(durable.sync(), std::runtime_error);
+
+    std::filesystem::remove(PATH);
+    std::filesystem::remove(PATH + ".snapshot");
+}
+
+TEST_CASE("DurableSkipList:UnknownOperation:ExpectThrows", "[DurableSkipList]") {
+    const std::string PATH = logPath("durable_unknown.wal");
+    {
+        proj2::WriteAheadLog log{PATH, proj2::WalOptions{}};
+        const unsigned char record[]{9, 1, 0, 0, 0};
+        log.commit(log.append(record, sizeof(record)));
+    }
+
+    using Durable = proj2::DurableSkipList<unsigned, unsigned>;
+    REQUIRE_THROWS_AS(Durable{PATH}, std::runtime_error);
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("WriteAheadLog:FailedWrite:ExpectEveryCommitThrowsFromThenOn",
+          "[DurableSkipList]") {
+    // Every write to /dev/full fails with ENOSPC
+    proj2::WriteAheadLog log{"/dev/full", proj2::WalOptions{1, size_t{1} << 20, false}};
+    const unsigned COMMITTERS = 2;
+
+    std::atomic<unsigned> failures{0};
+    std::latch appended{COMMITTERS};
+    std::vector<std::thread> committers;
+    for (unsigned t = 0; t < COMMITTERS; t++) {
+        committers.emplace_back([&log, &failures, &appended, t]() {
+            const auto sequence = log.append(&t, sizeof(t));
+            // Both records wait in one batch, so one committer leads and the
+            // other waits for it or finds the log failed
+            appended.arrive_and_wait();
+            try {
+                log.commit(sequence);
+            } catch (const std::runtime_error&) {
+                failures++;
+            }
+        });
+    }
+    for (std::thread& committer : committers) {
+        committer.join();
+    }
+
+    REQUIRE(failures == COMMITTERS);
+    REQUIRE(log.durableThrough() == 0);
+    const unsigned payload{7};
+    REQUIRE_THROWS_AS(log.append(&payload, sizeof(payload)), std::runtime_error);
+    REQUIRE_THROWS_AS(log.commit(1), std::runtime_error);
+    REQUIRE_THROWS_AS(log.sync(), std::runtime_error);
+    REQUIRE_THROWS_AS(log.reset(), std::runtime_error);
+}
+
+}  // namespace
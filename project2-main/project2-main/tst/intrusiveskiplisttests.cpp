@@ -0,0 +1,149 @@
+#include <IntrusiveSkipList.hpp>
+#include <algorithm>
+#include <catch2/catch_amalgamated.hpp>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+struct Record {
+    Record() = default;
+    Record(unsigned id, std::string name) : id{id}, name{std::move(name)} {}
+
+    unsigned id{0};
+    std::string name;
+    proj2::SkipListHook<Record> byIdHook;
+    proj2::SkipListHook<Record> byNameHook;
+};
+
+using ById = proj2::IntrusiveSkipList<Record, &Record::byIdHook, &Record::id>;
+using ByName = proj2::IntrusiveSkipList<Record, &Record::byNameHook, &Record::name>;
+
+TEST_CASE("IntrusiveSkipList:RandomOperations:ExpectSameAsStdSet", "[IntrusiveSkipList]") {
+    std::vector<Record> records(1000);
+    for (unsigned id = 0; id < records.size(); id++) {
+        records[id].id = id;
+    }
+    ById list;
+    std::set<unsigned> reference;
+    std::mt19937 random{46};
+
+    for (int step = 0; step < 10000; step++) {
+        Record& record{records[random() % records.size()]};
+        if (random() % 3 == 0 and reference.count(record.id) != 0) {
+            list.erase(record);
+            reference.erase(record.id);
+            REQUIRE_FALSE(record.byIdHook.linked());
+        } else if (reference.insert(record.id).second) {
+            REQUIRE(list.insert(record));
+        }
+    }
+
+    REQUIRE(list.size() == reference.size());
+    std::vector<unsigned> ids;
+    for (const Record& record : list) {
+        ids.push_back(record.id);
+    }
+    REQUIRE(std::equal(ids.begin(), ids.end(), reference.begin(), reference.end()));
+    for (unsigned id : reference) {
+        REQUIRE(list.find(id) == &records[id]);
+        REQUIRE(list.height(id) >= 1);
+        REQUIRE(list.height(id) <= proj2::SkipListHook<Record>::MAX_LAYERS);
+    }
+    REQUIRE(list.find(1000) == nullptr);
+    REQUIRE(list.lower_bound(1000) == list.end());
+}
+
+TEST_CASE("IntrusiveSkipList:ManyObjects:ExpectAboutOneInFourPromoted", "[IntrusiveSkipList]") {
+    const unsigned NUMBER_OF_ELEMENTS = 1 << 18;
+    std::vector<Record> records(NUMBER_OF_ELEMENTS);
+    ById list;
+    std::vector<size_t> onLayer(proj2::SkipListHook<Record>::MAX_LAYERS, 0);
+    for (unsigned id = 0; id < NUMBER_OF_ELEMENTS; id++) {
+        records[id].id = id;
+        REQUIRE(list.insert(records[id]));
+        for (size_t layer = 0; layer < records[id].byIdHook.height; layer++) {
+            onLayer[layer]++;
+        }
+    }
+
+    // 4^9 keys: nine layers or so, and no layer stacked with a fixed share
+    // of the keys
+    REQUIRE(list.layers() >= 8);
+    REQUIRE(list.layers() <= 12);
+    for (size_t layer = 1; layer < 6; layer++) {
+        REQUIRE(onLayer[layer] * 5 > onLayer[layer - 1]);
+        REQUIRE(onLayer[layer] * 3 < onLayer[layer - 1]);
+    }
+    REQUIRE(sizeof(proj2::SkipListHook<Record>) == 14 * sizeof(Record*) + sizeof(Record*));
+}
+
+TEST_CASE("IntrusiveSkipList:SeveralLists:ExpectEachOrderedByItsKey", "[IntrusiveSkipList]") {
+    std::vector<Record> records{{3, "carol"}, {1, "dave"}, {2, "alice"}, {4, "bob"}};
+    ById byId;
+    ByName byName;
+    for (Record& record : records) {
+        REQUIRE(byId.insert(record));
+        REQUIRE(byName.insert(record));
+    }
+
+    std::vector<std::string> names;
+    for (const Record& record : byId) {
+        names.push_back(record.name);
+    }
+    REQUIRE(names == std::vector<std::string>{"dave", "alice", "carol", "bob"});
+    REQUIRE(byName.begin()->id == 2);
+    REQUIRE(byName.lower_bound("c")->id == 3);
+
+    // Leaving one list does not touch the other
+    REQUIRE(byName.erase("carol") == &records[0]);
+    REQUIRE(byId.contains(3));
+    REQUIRE(byName.size() == 3);
+}
+
+TEST_CASE("IntrusiveSkipList:Misuse:ExpectThrowsAndNoChange", "[IntrusiveSkipList]") {
+    Record first{7, "first"};
+    Record second{7, "second"};
+    ById list;
+    REQUIRE(list.insert(first));
+    REQUIRE_THROWS_AS(list.insert(first), std::logic_error);
+
+    // Same key: refused, and left unlinked
+    REQUIRE_FALSE(list.insert(second));
+    REQUIRE_FALSE(second.byIdHook.linked());
+    REQUIRE_THROWS_AS(list.erase(second), std::invalid_argument);
+    REQUIRE_THROWS_AS(list.height(8), std::out_of_range);
+    REQUIRE(list.erase(8u) == nullptr);
+    REQUIRE(list.size() == 1);
+}
+
+TEST_CASE("IntrusiveSkipList:Clear:ExpectObjectsReusable", "[IntrusiveSkipList]") {
+    std::vector<Record> records(100);
+    for (unsigned id = 0; id < records.size(); id++) {
+        records[id].id = id;
+    }
+    {
+        ById list;
+        for (Record& record : records) {
+            list.insert(record);
+        }
+        list.clear();
+        REQUIRE(list.empty());
+        REQUIRE(list.layers() == 1);
+        REQUIRE(list.begin() == list.end());
+
+        for (Record& record : records) {
+            REQUIRE(list.insert(record));
+        }
+    }
+    // The destructor unlinked them too
+    REQUIRE(std::none_of(records.begin(), records.end(),
+                         [](const Record& record) { return record.byIdHook.linked(); }));
+}
+
+}  // namespace
@@ -0,0 +1,95 @@
+#include <SkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+struct PlainKeysTraits : proj2::SkipListTraits {
+    static constexpr bool ABBREVIATE_KEYS{false};
+};
+
+TEST_CASE("SkipList:StringKeyPrefix:ExpectSameOrderWhereDifferent", "[SkipList][KeyPrefix]") {
+    std::vector<std::string> keys{"",         "a",          "ab",        std::string("ab\0", 3),
+                                  "abcdefgh", "abcdefghi",  "abcdefgi",  "b",
+                                  "\x7f",     "\x80",       "\xff\xff",  "abcdefgh\xff"};
+    std::mt19937 random{46};
+    for (int i = 0; i < 200; i++) {
+        std::string key(random() % 12, '\0');
+        for (char& character : key) {
+            character = static_cast<char>("ab\0\xff"[random() % 4]);
+        }
+        keys.push_back(key);
+    }
+
+    for (const std::string& lhs : keys) {
+        for (const std::string& rhs : keys) {
+            uint64_t lhsPrefix{proj2::stringKeyPrefix(lhs)};
+            uint64_t rhsPrefix{proj2::stringKeyPrefix(rhs)};
+            if (lhsPrefix != rhsPrefix) {
+                REQUIRE((lhsPrefix < rhsPrefix) == (lhs < rhs));
+            }
+            if (lhs == rhs) {
+                REQUIRE(lhsPrefix == rhsPrefix);
+            }
+        }
+    }
+}
+
+TEST_CASE("SkipList:AbbreviatedKeys:ExpectSameAsPlainKeys", "[SkipList][KeyPrefix]") {
+    proj2::SkipList<std::string, unsigned> abbreviated;
+    proj2::SkipList<std::string, unsigned, PlainKeysTraits> plain;
+    std::map<std::string, unsigned> reference;
+    std::mt19937 random{46};
+
+    // Long shared prefixes make many cached prefixes tie
+    for (int step = 0; step < 5000; step++) {
+        std::string key{"prefix" + std::to_string(random() % 700)};
+        key.resize(6 + random() % 20, 'x');
+        if (random() % 4 == 0 and reference.count(key) != 0) {
+            abbreviated.erase(key);
+            plain.erase(key);
+            reference.erase(key);
+        } else {
+            auto value = static_cast<unsigned>(step);
+            bool inserted{reference.emplace(key, value).second};
+            REQUIRE(abbreviated.insert(key, value) == inserted);
+            REQUIRE(plain.insert(key, value) == inserted);
+        }
+    }
+
+    REQUIRE(abbreviated.allKeysInOrder() == plain.allKeysInOrder());
+    for (const auto& [key, value] : reference) {
+        REQUIRE(abbreviated.find(key) == value);
+        REQUIRE(abbreviated.contains(key + "x") == (reference.count(key + "x") != 0));
+        REQUIRE(abbreviated.height(key) == plain.height(key));
+    }
+    auto it = abbreviated.lower_bound("prefix35");
+    REQUIRE((*it).first == reference.lower_bound("prefix35")->first);
+}
+
+TEST_CASE("SkipList:AbbreviatedKeys:ExpectOnlyIndexNodesPayForPrefix", "[SkipList][KeyPrefix]") {
+    proj2::SkipList<unsigned, unsigned> numbers;
+    proj2::SkipList<unsigned, unsigned, PlainKeysTraits> plainNumbers;
+    proj2::SkipList<std::string, unsigned> strings;
+    proj2::SkipList<std::string, unsigned, PlainKeysTraits> plainStrings;
+    for (unsigned i = 0; i < 1000; i++) {
+        numbers.insert(i, i);
+        plainNumbers.insert(i, i);
+        strings.insert(std::to_string(i), i);
+        plainStrings.insert(std::to_string(i), i);
+    }
+
+    REQUIRE(numbers.structureReport().nodeBytes == plainNumbers.structureReport().nodeBytes);
+    // Key nodes above the base layer, sentinels excluded
+    proj2::SkipListReport report{strings.structureReport()};
+    size_t indexNodes{report.nodeCount - report.nodesPerLayer[0] - 2 * report.layers};
+    REQUIRE(indexNodes > 0);
+    REQUIRE(report.nodeBytes ==
+            plainStrings.structureReport().nodeBytes + indexNodes * sizeof(uint64_t));
+}
+
+}  // namespace
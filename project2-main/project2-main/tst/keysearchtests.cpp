@@ -0,0 +1,74 @@
+#include <KeySearch.hpp>
+#include <algorithm>
+#include <catch2/catch_amalgamated.hpp>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+// Every length up to a few vectors' worth, so both the vector loop and the
+// scalar tail are covered, probed at, between and beyond the keys
+template <typename K>
+void requireMatchesLowerBound(std::mt19937_64& random) {
+    for (size_t count = 0; count <= 40; count++) {
+        std::vector<K> keys;
+        for (size_t i = 0; i < count; i++) {
+            keys.push_back(static_cast<K>(random()));
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<K> probes{std::numeric_limits<K>::min(), std::numeric_limits<K>::max(),
+                              0};
+        for (const K& key : keys) {
+            probes.push_back(key);
+            probes.push_back(static_cast<K>(key + 1));
+            probes.push_back(static_cast<K>(key - 1));
+        }
+        for (const K& probe : probes) {
+            auto expected =
+                static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), probe) -
+                                    keys.begin());
+            REQUIRE(proj2::countLess(keys.data(), keys.size(), probe) == expected);
+        }
+    }
+}
+
+TEST_CASE("KeySearch:CountLess:ExpectSameAsLowerBound", "[KeySearch]") {
+    STATIC_REQUIRE(proj2::SimdSearchableKey<uint32_t>);
+    STATIC_REQUIRE(proj2::SimdSearchableKey<int64_t>);
+    STATIC_REQUIRE_FALSE(proj2::SimdSearchableKey<uint16_t>);
+    STATIC_REQUIRE_FALSE(proj2::SimdSearchableKey<double>);
+
+    std::mt19937_64 random{46};
+    requireMatchesLowerBound<uint32_t>(random);
+    requireMatchesLowerBound<uint64_t>(random);
+    requireMatchesLowerBound<int32_t>(random);
+    requireMatchesLowerBound<int64_t>(random);
+}
+
+TEST_CASE("KeySearch:CountLessHighBit:ExpectUnsignedOrder", "[KeySearch]") {
+    // Keys with the top bit set are the largest unsigned keys, not the
+    // smallest, as a signed compare would have them
+    std::vector<uint32_t> keys{1, 2, 0x7fffffff, 0x80000000, 0x80000001, 0xfffffffe,
+                               0xffffffff, 0xffffffff, 0xffffffff};
+    REQUIRE(proj2::countLess(keys.data(), keys.size(), uint32_t{0x80000000}) == 3);
+    REQUIRE(proj2::countLess(keys.data(), keys.size(), uint32_t{0xffffffff}) == 6);
+    REQUIRE(proj2::countLess(keys.data(), keys.size(), uint32_t{3}) == 2);
+
+    std::vector<uint64_t> wide{5, 0x8000000000000000, 0xffffffffffffffff};
+    REQUIRE(proj2::countLess(wide.data(), wide.size(), uint64_t{6}) == 1);
+    REQUIRE(proj2::countLess(wide.data(), wide.size(), uint64_t{0x8000000000000001}) == 2);
+}
+
+TEST_CASE("KeySearch:CountLessOtherKeys:ExpectBinarySearchFallback", "[KeySearch]") {
+    std::vector<std::string> keys{"apple", "banana", "cherry", "date"};
+    REQUIRE(proj2::countLess(keys.data(), keys.size(), std::string{"blueberry"}) == 2);
+    REQUIRE(proj2::countLess(keys.data(), keys.size(), std::string{"apple"}) == 0);
+    REQUIRE(proj2::countLess(keys.data(), keys.size(), std::string{"fig"}) == 4);
+}
+
+}  // namespace
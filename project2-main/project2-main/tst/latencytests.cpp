@@ -0,0 +1,128 @@
+#include <SkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+using TimedSkipList = proj2::SkipList<unsigned, unsigned, proj2::LatencySkipListTraits>;
+
+template <typename List>
+concept HasLatency = requires(const List& list) {
+    list.latencyHistogram(proj2::LatencyOperation::Find);
+};
+
+TEST_CASE("LatencyHistogram:Percentiles:ExpectWithinBucketPrecision",
+          "[LatencyHistogram]") {
+    proj2::LatencyHistogram histogram;
+    REQUIRE(histogram.percentile(99) == 0);
+
+    for (uint64_t value = 1; value <= 100000; value++) {
+        histogram.record(value);
+    }
+
+    REQUIRE(histogram.count() == 100000);
+    REQUIRE(histogram.min() == 1);
+    REQUIRE(histogram.max() == 100000);
+    REQUIRE(histogram.percentile(100) == 100000);
+    for (double percent : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+        const double exact{percent * 1000};
+        const auto reported = static_cast<double>(histogram.percentile(percent));
+        REQUIRE(reported >= exact);
+        REQUIRE(reported <= exact * (1 + 1.0 / proj2::LatencyHistogram::SUB_BUCKETS));
+    }
+}
+
+TEST_CASE("LatencyHistogram:Buckets:ExpectEveryValueInsideItsBucket",
+          "[LatencyHistogram]") {
+    for (uint64_t value : {0ULL, 31ULL, 32ULL, 33ULL, 1000ULL, 123456789ULL,
+                           ~0ULL >> 1, ~0ULL}) {
+        size_t bucket{proj2::LatencyHistogram::bucketOf(value)};
+        REQUIRE(bucket < proj2::LatencyHistogram::BUCKETS);
+        REQUIRE(value <= proj2::LatencyHistogram::highestInBucket(bucket));
+        if (bucket > 0) {
+            REQUIRE(value > proj2::LatencyHistogram::highestInBucket(bucket - 1));
+        }
+    }
+}
+
+TEST_CASE("LatencyHistogram:Merge:ExpectCombinedCounts", "[LatencyHistogram]") {
+    proj2::LatencyHistogram fast;
+    proj2::LatencyHistogram slow;
+    for (int i = 0; i < 990; i++) {
+        fast.record(100);
+    }
+    for (int i = 0; i < 10; i++) {
+        slow.record(1000000);
+    }
+    fast.merge(slow);
+
+    REQUIRE(fast.count() == 1000);
+    REQUIRE(fast.percentile(99) <= 103);
+    REQUIRE(fast.percentile(99.9) >= 1000000);
+    REQUIRE(fast.max() == 1000000);
+}
+
+TEST_CASE("LatencyRecorder:ManyShortLivedRecorders:ExpectThreadCacheBounded",
+          "[LatencyHistogram]") {
+    // One recorder stays alive throughout, so it has to survive every prune
+    proj2::LatencyRecorder kept;
+    kept.record(proj2::LatencyOperation::Find, 10);
+    for (int i = 0; i < 10000; i++) {
+        proj2::LatencyRecorder shortLived;
+        shortLived.record(proj2::LatencyOperation::Insert, 20);
+        kept.record(proj2::LatencyOperation::Find, 10);
+        REQUIRE(shortLived.histogram(proj2::LatencyOperation::Insert).count() == 1);
+    }
+    REQUIRE(proj2::LatencyRecorder::threadCacheSize() <= 32);
+    REQUIRE(kept.histogram(proj2::LatencyOperation::Find).count() == 10001);
+}
+
+TEST_CASE("SkipList:Latency:ExpectEveryOperationRecordedAcrossThreads",
+          "[SkipList][Latency]") {
+    STATIC_REQUIRE_FALSE(HasLatency<proj2::SkipList<unsigned, unsigned>>);
+    STATIC_REQUIRE(HasLatency<TimedSkipList>);
+
+    const unsigned int NUMBER_OF_ELEMENTS = 1000;
+    const unsigned int THREADS = 4;
+    TimedSkipList skipList;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.insert(i, i);
+    }
+    REQUIRE_THROWS(skipList.find(NUMBER_OF_ELEMENTS));
+
+    std::vector<std::thread> readers;
+    for (unsigned t = 0; t < THREADS; t++) {
+        readers.emplace_back([&skipList]() {
+            const TimedSkipList& list{skipList};
+            for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+                (void)list.contains(i);
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    skipList.erase(0);
+    skipList.parallelForEach(0, NUMBER_OF_ELEMENTS, [](unsigned, unsigned) {}, 2);
+
+    REQUIRE(skipList.latencyHistogram(proj2::LatencyOperation::Insert).count() ==
+            NUMBER_OF_ELEMENTS);
+    REQUIRE(skipList.latencyHistogram(proj2::LatencyOperation::Find).count() ==
+            THREADS * NUMBER_OF_ELEMENTS + 1);
+    REQUIRE(skipList.latencyHistogram(proj2::LatencyOperation::Erase).count() == 1);
+    REQUIRE(skipList.latencyHistogram(proj2::LatencyOperation::RangeScan).count() == 1);
+
+    std::ostringstream out;
+    skipList.writeLatencyPercentiles(out);
+    REQUIRE(out.str().find("insert: count=1000 p50=") != std::string::npos);
+    REQUIRE(out.str().find("range_scan: count=1 ") != std::string::npos);
+
+    skipList.resetLatency();
+    REQUIRE(skipList.latencyHistogram(proj2::LatencyOperation::Find).count() == 0);
+}
+
+}  // namespace
@@ -0,0 +1,126 @@
+#include <LsmStore.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+std::string storeDirectory(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(path);
+    return path.string();
+}
+
+proj2::LsmOptions smallMemtable() {
+    proj2::LsmOptions options;
+    options.memtableMaxKeys = 100;
+    options.indexInterval = 8;
+    return options;
+}
+
+TEST_CASE("LsmStore:PutsAcrossFlushes:ExpectNewestValueWins", "[LsmStore]") {
+    const std::string DIRECTORY = storeDirectory("lsm_newest");
+    proj2::LsmStore<unsigned, unsigned> store{DIRECTORY, smallMemtable()};
+
+    for (unsigned i = 0; i < 1000; i++) {
+        store.put(i, i);
+    }
+    for (unsigned i = 0; i < 1000; i += 2) {
+        store.put(i, i + 1);
+    }
+    store.flush();
+    REQUIRE(store.runCount() >= 10);
+
+    for (unsigned i = 0; i < 1000; i++) {
+        REQUIRE(store.get(i) == (i % 2 == 0 ? i + 1 : i));
+    }
+    REQUIRE_FALSE(store.get(1000).has_value());
+    std::filesystem::remove_all(DIRECTORY);
+}
+
+TEST_CASE("LsmStore:EraseThenCompact:ExpectTombstonesHideOlderRuns",
+          "[LsmStore]") {
+    const std::string DIRECTORY = storeDirectory("lsm_compact");
+    proj2::LsmStore<std::string, std::string> store{DIRECTORY, smallMemtable()};
+
+    for (unsigned i = 0; i < 500; i++) {
+        store.put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    store.flush();
+    for (unsigned i = 0; i < 500; i += 5) {
+        store.erase("key" + std::to_string(i));
+    }
+    store.flush();
+
+    REQUIRE_FALSE(store.contains("key0"));
+    REQUIRE(store.get("key1") == "value1");
+
+    store.compact();
+    REQUIRE(store.runCount() == 1);
+    REQUIRE_FALSE(store.contains("key0"));
+    REQUIRE_FALSE(store.contains("key495"));
+    REQUIRE(store.get("key499") == "value499");
+    std::filesystem::remove_all(DIRECTORY);
+}
+
+TEST_CASE("LsmStore:Reopen:ExpectRunsAndFlushedMemtableLoaded",
+          "[LsmStore]") {
+    const std::string DIRECTORY = storeDirectory("lsm_reopen");
+
+    {
+        proj2::LsmStore<unsigned, unsigned> store{DIRECTORY, smallMemtable()};
+        for (unsigned i = 0; i < 250; i++) {
+            store.put(i, i * 2);
+        }
+        store.compact();
+        store.erase(7);
+        // The destructor flushes what is left in the memtable
+    }
+
+    proj2::LsmStore<unsigned, unsigned> reopened{DIRECTORY, smallMemtable()};
+    REQUIRE(reopened.get(100) == 200U);
+    REQUIRE(reopened.get(249) == 498U);
+    REQUIRE_FALSE(reopened.contains(7));
+    std::filesystem::remove_all(DIRECTORY);
+}
+
+TEST_CASE("LsmStore:OverwriteWithLargerValues:ExpectFlushAtByteLimit", "[LsmStore]") {
+    const std::string DIRECTORY = storeDirectory("lsm_overwrite");
+    proj2::LsmOptions options;
+    options.memtableMaxBytes = 4096;
+    proj2::LsmStore<unsigned, std::string> store{DIRECTORY, options};
+
+    // Small at first, so only the overwrites can reach the limit
+    for (unsigned i = 0; i < 8; i++) {
+        store.put(i, "");
+    }
+    for (unsigned i = 0; i < 8; i++) {
+        store.put(i, std::string(1000, 'x'));
+    }
+    store.put(100, "");
+    store.flush();
+    // Runs frozen at the limit, then one from flush()
+    REQUIRE(store.runCount() >= 2);
+    for (unsigned i = 0; i < 8; i++) {
+        REQUIRE(store.get(i) == std::string(1000, 'x'));
+    }
+    std::filesystem::remove_all(DIRECTORY);
+}
+
+TEST_CASE("LsmStore:ZeroOption:ExpectThrows", "[LsmStore]") {
+    const std::string DIRECTORY = storeDirectory("lsm_options");
+
+    proj2::LsmOptions noIndex{smallMemtable()};
+    noIndex.indexInterval = 0;
+    REQUIRE_THROWS_AS((proj2::LsmStore<unsigned, unsigned>{DIRECTORY, noIndex}),
+                      std::invalid_argument);
+    proj2::LsmOptions noBloom{smallMemtable()};
+    noBloom.bloomBitsPerKey = 0;
+    REQUIRE_THROWS_AS((proj2::LsmStore<unsigned, unsigned>{DIRECTORY, noBloom}),
+                      std::invalid_argument);
+    std::filesystem::remove_all(DIRECTORY);
+}
+
+}  // namespace
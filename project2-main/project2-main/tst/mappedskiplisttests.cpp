@@ -0,0 +1,175 @@
+#include <MappedSkipList.hpp>
+#include <SkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+std::string mappedPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+template <typename Iterator>
+constexpr bool isProxyForwardIterator() {
+    return std::forward_iterator<Iterator> and
+           std::is_same_v<typename std::iterator_traits<Iterator>::iterator_category,
+                          std::input_iterator_tag>;
+}
+
+TEST_CASE("MappedSkipList:IteratorCategory:ExpectForwardConceptInputTag", "[MappedSkipList]") {
+    // Both dereference to a pair of references, not to a reference
+    using MappedIterator = proj2::MappedSkipList<unsigned, unsigned>::const_iterator;
+    using ListIterator = proj2::SkipList<unsigned, unsigned>::const_iterator;
+    STATIC_REQUIRE(isProxyForwardIterator<MappedIterator>());
+    STATIC_REQUIRE(isProxyForwardIterator<ListIterator>());
+}
+
+TEST_CASE("MappedSkipList:WriteAndMap:ExpectSameReadApiAsSkipList",
+          "[MappedSkipList]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 5000;
+    const std::string PATH = mappedPath("mapped_unsigned.map");
+
+    proj2::SkipList<unsigned, uint64_t> skipList;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.insert(i * 2, uint64_t{i} * 10);
+    }
+    proj2::MappedSkipList<unsigned, uint64_t>::write(skipList, PATH);
+
+    proj2::MappedSkipList<unsigned, uint64_t> mapped{PATH};
+    mapped.verify();
+
+    REQUIRE(mapped.size() == skipList.size());
+    REQUIRE(mapped.layers() == skipList.layers());
+    REQUIRE(mapped.allKeysInOrder() == skipList.allKeysInOrder());
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(mapped.find(i * 2) == uint64_t{i} * 10);
+        REQUIRE(mapped.contains(i * 2));
+        REQUIRE_FALSE(mapped.contains(i * 2 + 1));
+        // Past the largest key both give end(), which has no key to read
+        auto expected = skipList.lower_bound(i * 2 + 1);
+        auto actual = mapped.lower_bound(i * 2 + 1);
+        REQUIRE((actual == mapped.end()) == (expected == skipList.end()));
+        if (expected != skipList.end()) {
+            REQUIRE((*actual).first == (*expected).first);
+        }
+    }
+    REQUIRE(mapped.nextKey(10) == 12);
+    REQUIRE(mapped.previousKey(10) == 8);
+    REQUIRE_THROWS_AS(mapped.find(1), std::out_of_range);
+    REQUIRE_THROWS_AS(mapped.nextKey((NUMBER_OF_ELEMENTS - 1) * 2),
+                      std::out_of_range);
+    REQUIRE_THROWS_AS(mapped.previousKey(0), std::out_of_range);
+    REQUIRE(mapped.lower_bound(NUMBER_OF_ELEMENTS * 2) == mapped.end());
+
+    size_t visited{0};
+    for (auto [key, value] : mapped) {
+        REQUIRE(value == uint64_t{key} * 5);
+        visited++;
+    }
+    REQUIRE(visited == NUMBER_OF_ELEMENTS);
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("MappedSkipList:EmptyList:ExpectNothingFound", "[MappedSkipList]") {
+    const std::string PATH = mappedPath("mapped_empty.map");
+
+    proj2::SkipList<unsigned, unsigned> skipList;
+    proj2::MappedSkipList<unsigned, unsigned>::write(skipList, PATH);
+    proj2::MappedSkipList<unsigned, unsigned> mapped{PATH};
+
+    REQUIRE(mapped.empty());
+    REQUIRE(mapped.layers() == 2);
+    REQUIRE_FALSE(mapped.contains(0));
+    REQUIRE(mapped.begin() == mapped.end());
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("MappedSkipList:WrongTypeOrCorruptFile:ExpectThrows",
+          "[MappedSkipList]") {
+    const std::string PATH = mappedPath("mapped_corrupt.map");
+
+    proj2::SkipList<unsigned, unsigned> skipList;
+    for (unsigned i = 0; i < 100; i++) {
+        skipList.insert(i, i);
+    }
+    proj2::MappedSkipList<unsigned, unsigned>::write(skipList, PATH);
+
+    using WrongType = proj2::MappedSkipList<uint64_t, unsigned>;
+    REQUIRE_THROWS_AS(WrongType{PATH}, std::runtime_error);
+
+    {
+        std::fstream file{PATH, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(static_cast<std::streamoff>(
+            std::filesystem::file_size(PATH) / 2));
+        file.put('\x7f');
+    }
+    proj2::MappedSkipList<unsigned, unsigned> mapped{PATH};
+    REQUIRE_THROWS_AS(mapped.verify(), std::runtime_error);
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("MappedSkipList:WriteWithOtherTraits:ExpectSameFile", "[MappedSkipList]") {
+    const std::string PLAIN_PATH = mappedPath("mapped_plain.map");
+    const std::string COUNTING_PATH = mappedPath("mapped_counting.map");
+
+    proj2::SkipList<unsigned, unsigned> plain;
+    proj2::SkipList<unsigned, unsigned, proj2::CountingSkipListTraits> counting;
+    for (unsigned i = 0; i < 1000; i++) {
+        plain.insert(i * 3, i);
+        counting.insert(i * 3, i);
+    }
+    proj2::MappedSkipList<unsigned, unsigned>::write(plain, PLAIN_PATH);
+    proj2::MappedSkipList<unsigned, unsigned>::write(counting, COUNTING_PATH);
+
+    proj2::MappedSkipList<unsigned, unsigned> mapped{COUNTING_PATH};
+    mapped.verify();
+    REQUIRE(mapped.allKeysInOrder() == counting.allKeysInOrder());
+    REQUIRE(mapped.find(999) == 333);
+    REQUIRE(std::filesystem::file_size(PLAIN_PATH) == std::filesystem::file_size(COUNTING_PATH));
+    std::filesystem::remove(PLAIN_PATH);
+    std::filesystem::remove(COUNTING_PATH);
+}
+
+// Overwrite the next of the top layer's head, which a search follows
+// first; 0 points it back at the head itself
+void damageTopHead(const std::string& path, uint64_t next) {
+    std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+    const auto topHeadField = static_cast<std::streamoff>(5 * sizeof(uint64_t));
+    uint64_t topHead{0};
+    file.seekg(topHeadField);
+    file.read(reinterpret_cast<char*>(&topHead), sizeof(topHead));
+    if (next == 0) {
+        next = topHead;
+    }
+    file.seekp(static_cast<std::streamoff>(topHead + sizeof(uint64_t)));
+    file.write(reinterpret_cast<const char*>(&next), sizeof(next));
+}
+
+TEST_CASE("MappedSkipList:DamagedOffset:ExpectSearchThrows", "[MappedSkipList]") {
+    const std::string PATH = mappedPath("mapped_damaged.map");
+
+    proj2::SkipList<unsigned, unsigned> skipList;
+    for (unsigned i = 0; i < 1000; i++) {
+        skipList.insert(i, i);
+    }
+
+    // Past the end, into the header, not at a node's start, and a loop
+    for (uint64_t next : {uint64_t{1} << 40, uint64_t{8}, uint64_t{1}, uint64_t{0}}) {
+        proj2::MappedSkipList<unsigned, unsigned>::write(skipList, PATH);
+        damageTopHead(PATH, next);
+        proj2::MappedSkipList<unsigned, unsigned> mapped{PATH};
+        REQUIRE_THROWS_AS(mapped.find(999), std::runtime_error);
+        REQUIRE_THROWS_AS(mapped.contains(999), std::runtime_error);
+        REQUIRE(mapped.size() == 1000);
+    }
+    std::filesystem::remove(PATH);
+}
+
+}  // namespace
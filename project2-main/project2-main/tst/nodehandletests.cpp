@@ -0,0 +1,188 @@
+#include <SkipList.hpp>
+#include <array>
+#include <catch2/catch_amalgamated.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+struct NoBackLinksTraits : proj2::SkipListTraits {
+    static constexpr proj2::BackLinks BACK_LINKS{proj2::BackLinks::None};
+};
+
+// Every other key moves to a second list, and its value stays where it was
+template <typename Traits>
+void requireMovedWithoutCopies() {
+    proj2::SkipList<unsigned, unsigned, Traits> from;
+    proj2::SkipList<unsigned, unsigned, Traits> to;
+    std::vector<std::pair<unsigned, size_t>> heights;
+    for (unsigned key = 0; key < 1000; key++) {
+        from.insert(key, key * 2);
+        heights.emplace_back(key, from.height(key));
+    }
+
+    for (unsigned key = 0; key < 1000; key += 2) {
+        const unsigned* value{&from.find(key)};
+        auto node = from.extract(key);
+        REQUIRE(node.key() == key);
+        auto result = to.insert(std::move(node));
+        REQUIRE(result.inserted);
+        REQUIRE(result.node.empty());
+        REQUIRE((*result.position).first == key);
+        REQUIRE(&to.find(key) == value);
+    }
+
+    REQUIRE(from.size() == 500);
+    REQUIRE(to.size() == 500);
+    for (auto [key, height] : heights) {
+        auto& list = key % 2 == 0 ? to : from;
+        REQUIRE(list.find(key) == key * 2);
+        REQUIRE(list.height(key) == height);
+        if (key >= 2) {
+            REQUIRE(list.previousKey(key) == key - 2);
+        }
+    }
+    REQUIRE(to.isLargestKey(998));
+    REQUIRE(from.isSmallestKey(1));
+}
+
+TEST_CASE("SkipList:ExtractInsert:ExpectTowerMovedWithoutCopies", "[SkipList][NodeHandle]") {
+    requireMovedWithoutCopies<proj2::SkipListTraits>();
+    requireMovedWithoutCopies<NoBackLinksTraits>();
+}
+
+TEST_CASE("SkipList:ExtractRekey:ExpectFoundUnderNewKey", "[SkipList][NodeHandle]") {
+    proj2::SkipList<std::string, int> skipList;
+    for (int i = 0; i < 100; i++) {
+        skipList.insert("key" + std::to_string(i), i);
+    }
+    size_t height{skipList.height("key42")};
+
+    auto node = skipList.extract("key42");
+    REQUIRE_FALSE(skipList.contains("key42"));
+    node.key() = "zzz";
+    node.mapped() = -1;
+    REQUIRE(skipList.insert(std::move(node)).inserted);
+
+    REQUIRE(skipList.find("zzz") == -1);
+    REQUIRE(skipList.height("zzz") == height);
+    REQUIRE(skipList.isLargestKey("zzz"));
+    REQUIRE(skipList.previousKey("zzz") == "key99");
+    REQUIRE(skipList.size() == 100);
+    for (int i = 0; i < 100; i++) {
+        if (i != 42) {
+            REQUIRE(skipList.find("key" + std::to_string(i)) == i);
+        }
+    }
+}
+
+TEST_CASE("SkipList:InsertNodeDuplicate:ExpectHandleReturned", "[SkipList][NodeHandle]") {
+    proj2::SkipList<unsigned, std::string> skipList;
+    skipList.insert(1, "one");
+    skipList.insert(2, "two");
+
+    REQUIRE(skipList.extract(3).empty());
+    auto missing = skipList.insert(proj2::SkipList<unsigned, std::string>::node_type{});
+    REQUIRE_FALSE(missing.inserted);
+    REQUIRE(missing.position == skipList.end());
+
+    auto node = skipList.extract(2);
+    skipList.insert(2, "second two");
+    auto result = skipList.insert(std::move(node));
+    REQUIRE_FALSE(result.inserted);
+    REQUIRE(result.node);
+    REQUIRE(result.node.mapped() == "two");
+    REQUIRE((*result.position).second == "second two");
+    // The handle frees its tower when it goes out of scope
+}
+
+struct Large {
+    std::array<char, 512> bytes{};
+    std::shared_ptr<int> owned;
+};
+
+TEST_CASE("SkipList:ExtractLargeValue:ExpectValueStaysWithTower", "[SkipList][NodeHandle]") {
+    proj2::SkipList<unsigned, Large> to;
+    std::vector<const Large*> addresses;
+    {
+        proj2::SkipList<unsigned, Large> from;
+        for (unsigned key = 0; key < 50; key++) {
+            Large value;
+            value.bytes[0] = static_cast<char>(key);
+            from.insert(key, value);
+            from.find(key).owned = std::make_shared<int>(static_cast<int>(key));
+        }
+        for (unsigned key = 10; key < 20; key++) {
+            addresses.push_back(&from.find(key));
+            REQUIRE(to.insert(from.extract(key)).inserted);
+        }
+        REQUIRE(from.size() == 40);
+    }
+
+    REQUIRE(to.size() == 10);
+    for (unsigned key = 10; key < 20; key++) {
+        REQUIRE(&to.find(key) == addresses[key - 10]);
+        REQUIRE(to.find(key).bytes[0] == static_cast<char>(key));
+        REQUIRE(*to.find(key).owned == static_cast<int>(key));
+        REQUIRE(to.find(key).owned.use_count() == 1);
+    }
+}
+
+TEST_CASE("SkipList:HandleOutlivesList:ExpectTowerStillOwned", "[SkipList][NodeHandle]") {
+    using LargeList = proj2::SkipList<std::string, Large>;
+    auto tracker = std::make_shared<int>(7);
+    LargeList::node_type kept;
+    LargeList::node_type dropped;
+    {
+        LargeList from;
+        for (int i = 0; i < 200; i++) {
+            from.insert("key" + std::to_string(i), Large{{}, tracker});
+        }
+        kept = from.extract("key42");
+        dropped = from.extract("key43");
+        from.clear();
+        from.insert("again", Large{{}, tracker});
+    }
+    // Only the two handles' values are left
+    REQUIRE(tracker.use_count() == 3);
+    REQUIRE(kept.key() == "key42");
+    REQUIRE(kept.mapped().owned == tracker);
+
+    dropped = {};
+    REQUIRE(tracker.use_count() == 2);
+
+    LargeList to;
+    to.insert("other", Large{});
+    REQUIRE(to.insert(std::move(kept)).inserted);
+    REQUIRE(to.find("key42").owned == tracker);
+    REQUIRE(to.previousKey("other") == "key42");
+    to.erase("key42");
+    REQUIRE(tracker.use_count() == 1);
+}
+
+TEST_CASE("SkipList:InsertHandleFromOtherList:ExpectSourceChunkKept", "[SkipList][NodeHandle]") {
+    proj2::SkipList<unsigned, unsigned> to;
+    to.insert(1, 1);
+    const size_t before{to.storageBytes()};
+    {
+        proj2::SkipList<unsigned, unsigned> from;
+        for (unsigned key = 0; key < 2000; key++) {
+            from.insert(key * 2, key);
+        }
+        REQUIRE(to.insert(from.extract(2000)).inserted);
+    }
+    // The tower's base node brings the whole 4 KiB chunk it sits in
+    REQUIRE(to.storageBytes() >= before + 4000);
+
+    to.erase(2000);
+    to.shrinkToFit();
+    REQUIRE(to.storageBytes() >= before + 4000);
+    to.clear();
+    to.shrinkToFit();
+    REQUIRE(to.storageBytes() < before + 4000);
+}
+
+}  // namespace
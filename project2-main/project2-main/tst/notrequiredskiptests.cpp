@@ -144,6 +144,39 @@ TEST_CASE("SkipList:InsertTestStrings:ExpectFoundValueEqualsInsertedValueAndChan
     skipList.printSkipList();
 }
 
+TEST_CASE("SkipList:InsertExistingKey:ExpectFalseAndNoDuplicate",
+          "[Sample][SkipList][InsertFind]") {
+    proj2::SkipList<unsigned, unsigned> skipList;
+
+    REQUIRE(skipList.insert(5, 5));
+    REQUIRE(skipList.insert(3, 3));
+    REQUIRE_FALSE(skipList.insert(5, 10));
+    REQUIRE_FALSE(skipList.insert(3, 10));
+
+    REQUIRE(skipList.size() == 2);
+    REQUIRE(skipList.allKeysInOrder() == std::vector<unsigned>{3, 5});
+    REQUIRE(skipList.find(5) == 5);
+}
+
+TEST_CASE("SkipList:InsertAllHeadsKeyAfterErases:ExpectLayerCapStillApplies",
+          "[Sample][SkipList][InsertFind]") {
+    proj2::SkipList<unsigned, unsigned> skipList;
+
+    // 255 and 65280 flip heads forever, so their towers stop at the cap
+    for (unsigned i = 0; i < 100; i++) {
+        skipList.insert(i * 1000 + 1, i);
+    }
+    REQUIRE(skipList.insert(255, 255));
+    const size_t tallLayers{skipList.layers()};
+    for (unsigned i = 0; i < 100; i++) {
+        skipList.erase(i * 1000 + 1);
+    }
+
+    REQUIRE(skipList.insert(65280, 65280));
+    REQUIRE(skipList.layers() == tallLayers);
+    REQUIRE(skipList.allKeysInOrder() == std::vector<unsigned>{255, 65280});
+}
+
 TEST_CASE("FAILCASES")
 {
     proj2::SkipList<std::string, std::string> skipList;
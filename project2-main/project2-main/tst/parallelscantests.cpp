@@ -0,0 +1,104 @@
+#include <SkipList.hpp>
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_amalgamated.hpp>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+TEST_CASE("SkipList:ParallelForEach:ExpectEveryKeyInRangeVisitedOnce",
+          "[SkipList][ParallelScan]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 5000;
+    const unsigned int LOW = 1000;
+    const unsigned int HIGH = 4000;
+    const size_t THREADS = 4;
+
+    proj2::SkipList<unsigned, unsigned> skipList;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.insert(i, i * 2);
+    }
+
+    // Catch2 assertions are not thread safe, so results are checked after
+    std::mutex lock;
+    std::vector<unsigned> visited;
+    std::atomic<int> wrongValues{0};
+    skipList.parallelForEach(
+        LOW, HIGH,
+        [&](const unsigned& key, const unsigned& value) {
+            if (value != key * 2) {
+                wrongValues++;
+            }
+            std::lock_guard<std::mutex> guard{lock};
+            visited.push_back(key);
+        },
+        THREADS);
+
+    REQUIRE(wrongValues == 0);
+
+    std::sort(visited.begin(), visited.end());
+    std::vector<unsigned> expected;
+    for (unsigned i = LOW; i < HIGH; i++) {
+        expected.push_back(i);
+    }
+    REQUIRE(visited == expected);
+}
+
+TEST_CASE("SkipList:ParallelReduce:ExpectSameResultAsSequentialFold",
+          "[SkipList][ParallelScan]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 3000;
+    const size_t THREADS = 3;
+
+    proj2::SkipList<unsigned, unsigned> skipList;
+    unsigned long long expectedSum{0};
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.insert(i, i);
+        expectedSum += i;
+    }
+
+    auto sum = skipList.parallelReduce(
+        0U, NUMBER_OF_ELEMENTS, 0ULL,
+        [](const unsigned&, const unsigned& value) {
+            return static_cast<unsigned long long>(value);
+        },
+        [](unsigned long long lhs, unsigned long long rhs) { return lhs + rhs; },
+        THREADS);
+    REQUIRE(sum == expectedSum);
+
+    // Concatenation is not commutative, so this also checks chunk order
+    auto keys = skipList.parallelReduce(
+        100U, 200U, std::vector<unsigned>{},
+        [](const unsigned& key, const unsigned&) {
+            return std::vector<unsigned>{key};
+        },
+        [](std::vector<unsigned> lhs, std::vector<unsigned> rhs) {
+            lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+            return lhs;
+        },
+        THREADS);
+    std::vector<unsigned> expected;
+    for (unsigned i = 100; i < 200; i++) {
+        expected.push_back(i);
+    }
+    REQUIRE(keys == expected);
+}
+
+TEST_CASE("SkipList:ParallelScanEmptyRanges:ExpectNoCalls",
+          "[SkipList][ParallelScan]") {
+    proj2::SkipList<std::string, std::string> skipList;
+    std::atomic<int> calls{0};
+    auto count = [&](const std::string&, const std::string&) { calls++; };
+
+    skipList.parallelForEach("A", "Z", count);
+    skipList.insert("Shindler", "ICS 46");
+    skipList.parallelForEach("Z", "A", count);
+    skipList.parallelForEach("T", "Z", count);
+    REQUIRE(calls == 0);
+
+    skipList.parallelForEach("A", "Z", count);
+    REQUIRE(calls == 1);
+}
+
+}  // namespace
@@ -0,0 +1,202 @@
+#include <SkipList.hpp>
+#include <array>
+#include <atomic>
+#include <catch2/catch_amalgamated.hpp>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// Calls to the global allocator while countAllocations is set, for the
+// whole test program
+namespace {
+std::atomic<bool> countAllocations{false};
+std::atomic<size_t> allocations{0};
+}  // namespace
+
+void* operator new(size_t bytes) {
+    if (countAllocations) {
+        allocations++;
+    }
+    void* block{std::malloc(bytes == 0 ? 1 : bytes)};
+    if (block == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    std::free(block);
+}
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+// Keys whose bytes XOR to 0x7F, so the first seven coin flips come up
+// heads: eight nodes a key where the reserve allows for two on average
+unsigned tallTowerKey(unsigned i) {
+    unsigned key{i << 8};
+    unsigned hash{(key >> 24) ^ (key >> 16) ^ (key >> 8)};
+    return key | ((hash ^ 0x7F) & 0xFF);
+}
+
+template <typename V>
+size_t allocationsWhileInserting(proj2::SkipList<unsigned, V>& skipList,
+                                 const std::vector<unsigned>& keys) {
+    const V value{};
+    allocations = 0;
+    countAllocations = true;
+    for (unsigned key : keys) {
+        skipList.insert(key, value);
+    }
+    countAllocations = false;
+    return allocations;
+}
+
+TEST_CASE("SkipList:Reserve:ExpectInsertsTakeReservedNodes", "[SkipList][Reserve]") {
+    proj2::SkipList<unsigned, unsigned, proj2::CountingSkipListTraits> skipList;
+    skipList.reserve(10000);
+    size_t reserved{skipList.reservedNodes()};
+    REQUIRE(reserved >= 20000);
+
+    std::mt19937 random{46};
+    while (skipList.size() < 10000) {
+        skipList.insert(static_cast<unsigned>(random()), 0);
+    }
+    // Every node made, sentinels of new layers included, came out of the
+    // reserve
+    REQUIRE(skipList.stats().nodesAllocated == reserved - skipList.reservedNodes());
+    REQUIRE(skipList.reservedNodes() > 0);
+}
+
+struct Large {
+    std::array<char, 256> bytes{};
+};
+
+TEST_CASE("SkipList:ReserveLargeValues:ExpectValuesTakeReservedSlots", "[SkipList][Reserve]") {
+    proj2::SkipList<unsigned, Large> skipList;
+    REQUIRE(skipList.reservedValues() == 0);
+    skipList.reserve(5000);
+    size_t reserved{skipList.reservedValues()};
+    REQUIRE(reserved >= 5000);
+
+    std::mt19937 random{46};
+    while (skipList.size() < 5000) {
+        Large value;
+        value.bytes[0] = static_cast<char>(skipList.size());
+        skipList.insert(static_cast<unsigned>(random()), value);
+    }
+    // No value needed a chunk of its own
+    REQUIRE(skipList.reservedValues() == reserved - 5000);
+
+    skipList.clear();
+    skipList.shrinkToFit();
+    REQUIRE(skipList.reservedValues() == 0);
+    // Inline values never hold a reserve
+    proj2::SkipList<unsigned, unsigned> small;
+    small.reserve(100);
+    REQUIRE(small.reservedValues() == 0);
+}
+
+TEST_CASE("SkipList:Reserve:ExpectNoAllocationWhileInserting", "[SkipList][Reserve]") {
+    std::vector<unsigned> randomKeys;
+    std::mt19937 random{46};
+    for (unsigned i = 0; i < 5000; i++) {
+        randomKeys.push_back(static_cast<unsigned>(random()));
+    }
+    std::vector<unsigned> tallKeys;
+    for (unsigned i = 0; i < 5000; i++) {
+        tallKeys.push_back(tallTowerKey(i));
+        REQUIRE(proj2::flipCoin(tallKeys.back(), 6));
+        REQUIRE_FALSE(proj2::flipCoin(tallKeys.back(), 7));
+    }
+
+    for (const auto& keys : {randomKeys, tallKeys}) {
+        proj2::SkipList<unsigned, unsigned> small;
+        small.reserve(keys.size());
+        REQUIRE(allocationsWhileInserting(small, keys) == 0);
+        REQUIRE(small.size() == keys.size());
+
+        proj2::SkipList<unsigned, Large> large;
+        large.reserve(keys.size());
+        REQUIRE(allocationsWhileInserting(large, keys) == 0);
+        REQUIRE(large.size() == keys.size());
+    }
+
+    // Past the reserve, towers grow as tall as their coins say again
+    proj2::SkipList<unsigned, unsigned> reserved;
+    reserved.reserve(tallKeys.size());
+    allocationsWhileInserting(reserved, tallKeys);
+    proj2::SkipList<unsigned, unsigned> unreserved;
+    allocationsWhileInserting(unreserved, tallKeys);
+    REQUIRE(reserved.structureReport().nodeCount < unreserved.structureReport().nodeCount);
+    REQUIRE(reserved.insert(tallTowerKey(6000), 0));
+    REQUIRE(unreserved.insert(tallTowerKey(6000), 0));
+    REQUIRE(reserved.height(tallTowerKey(6000)) == unreserved.height(tallTowerKey(6000)));
+}
+
+TEST_CASE("SkipList:ShrinkToFit:ExpectUnusedReserveReleased", "[SkipList][Reserve]") {
+    proj2::SkipList<unsigned, std::string> skipList;
+    // The sentinels' first chunk has room to spare from the start
+    size_t fresh{skipList.reservedNodes()};
+    skipList.reserve(1000);
+    skipList.shrinkToFit();
+    REQUIRE(skipList.reservedNodes() == fresh);
+
+    // Reserved nodes and nodes from chunks added later mixed, since the
+    // reserve runs out
+    skipList.reserve(100);
+    for (unsigned key = 0; key < 1000; key++) {
+        skipList.insert(key, std::to_string(key));
+    }
+    // Nodes still in use keep their chunk
+    for (unsigned key = 0; key < 1000; key += 2) {
+        skipList.erase(key);
+    }
+    skipList.shrinkToFit();
+    for (unsigned key = 1; key < 1000; key += 2) {
+        REQUIRE(skipList.find(key) == std::to_string(key));
+    }
+
+    for (unsigned key = 1; key < 1000; key += 2) {
+        skipList.erase(key);
+    }
+    // The base nodes' chunk is all free now; the sentinels of the layers
+    // the keys added still hold on to the index nodes' chunk
+    size_t reserved{skipList.reservedNodes()};
+    skipList.shrinkToFit();
+    REQUIRE(skipList.reservedNodes() < reserved);
+    REQUIRE(skipList.insert(7, "seven"));
+    REQUIRE(skipList.find(7) == "seven");
+}
+
+TEST_CASE("SkipList:ReserveExtract:ExpectTowerOutlivesItsList", "[SkipList][Reserve]") {
+    proj2::SkipList<unsigned, std::shared_ptr<int>> to;
+    std::vector<size_t> heights;
+    {
+        proj2::SkipList<unsigned, std::shared_ptr<int>> from;
+        from.reserve(100);
+        for (unsigned key = 0; key < 100; key++) {
+            from.insert(key, std::make_shared<int>(static_cast<int>(key)));
+            heights.push_back(from.height(key));
+        }
+        for (unsigned key = 0; key < 100; key++) {
+            REQUIRE(to.insert(from.extract(key)).inserted);
+        }
+    }
+
+    REQUIRE(to.size() == 100);
+    for (unsigned key = 0; key < 100; key++) {
+        REQUIRE(*to.find(key) == static_cast<int>(key));
+        REQUIRE(to.find(key).use_count() == 1);
+        REQUIRE(to.height(key) == heights[key]);
+    }
+}
+
+}  // namespace
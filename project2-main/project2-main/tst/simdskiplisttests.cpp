@@ -0,0 +1,142 @@
+#include <SimdSkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+template <typename K>
+void requireSameAsMap(const proj2::SimdSkipList<K, unsigned>& skipList,
+                      const std::map<K, unsigned>& reference) {
+    REQUIRE(skipList.size() == reference.size());
+    auto it = skipList.begin();
+    for (const auto& [key, value] : reference) {
+        REQUIRE(it != skipList.end());
+        REQUIRE((*it).first == key);
+        REQUIRE((*it).second == value);
+        REQUIRE(skipList.find(key) == value);
+        ++it;
+    }
+    REQUIRE(it == skipList.end());
+}
+
+template <typename K>
+void randomOperations(uint32_t seed, K spread) {
+    proj2::SimdSkipList<K, unsigned> skipList;
+    std::map<K, unsigned> reference;
+    std::mt19937_64 random{seed};
+
+    for (unsigned step = 0; step < 30000; step++) {
+        auto key = static_cast<K>(random() % spread);
+        if (random() % 3 == 0 and reference.count(key) != 0) {
+            skipList.erase(key);
+            reference.erase(key);
+        } else {
+            REQUIRE(skipList.insert(key, step) == reference.emplace(key, step).second);
+        }
+    }
+    requireSameAsMap(skipList, reference);
+
+    for (K probe = 0; probe < spread; probe++) {
+        auto expected = reference.lower_bound(probe);
+        auto actual = skipList.lower_bound(probe);
+        REQUIRE((actual == skipList.end()) == (expected == reference.end()));
+        if (expected != reference.end()) {
+            REQUIRE((*actual).first == expected->first);
+        }
+    }
+
+    // Erasing everything drops every layer above the base
+    for (const auto& [key, value] : reference) {
+        skipList.erase(key);
+    }
+    REQUIRE(skipList.empty());
+    REQUIRE(skipList.layers() == 1);
+    REQUIRE(skipList.begin() == skipList.end());
+}
+
+TEST_CASE("SimdSkipList:RandomOperations32:ExpectSameAsStdMap", "[SimdSkipList]") {
+    randomOperations<uint32_t>(46, 5000);
+}
+
+TEST_CASE("SimdSkipList:RandomOperations64:ExpectSameAsStdMap", "[SimdSkipList]") {
+    randomOperations<uint64_t>(47, 5000);
+}
+
+TEST_CASE("SimdSkipList:Insert:ExpectTowersIndependentOfOrder", "[SimdSkipList]") {
+    const unsigned NUMBER_OF_ELEMENTS = 20000;
+    proj2::SimdSkipList<unsigned, unsigned> ascending;
+    proj2::SimdSkipList<unsigned, unsigned> scattered;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(ascending.insert(i, i));
+        REQUIRE(scattered.insert(i * 7919 % NUMBER_OF_ELEMENTS, i * 7919 % NUMBER_OF_ELEMENTS));
+    }
+    REQUIRE_FALSE(ascending.insert(3, 0));
+    REQUIRE(ascending.find(3) == 3);
+
+    REQUIRE(ascending.layers() == scattered.layers());
+    // About one key in FANOUT goes up each layer
+    REQUIRE(ascending.layers() >= 3);
+    REQUIRE(ascending.layers() <= 6);
+    REQUIRE(ascending.allKeysInOrder() == scattered.allKeysInOrder());
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(ascending.height(i) == scattered.height(i));
+        REQUIRE(scattered.find(i) == i);
+    }
+}
+
+TEST_CASE("SimdSkipList:NeighbouringKeys:ExpectAcrossBlocks", "[SimdSkipList]") {
+    const unsigned NUMBER_OF_ELEMENTS = 3000;
+    proj2::SimdSkipList<unsigned, unsigned> skipList;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.insert(i * 2, i);
+    }
+    // Every key, including those that start a block on some layer
+    for (unsigned i = 1; i + 1 < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(skipList.nextKey(i * 2) == i * 2 + 2);
+        REQUIRE(skipList.previousKey(i * 2) == i * 2 - 2);
+    }
+    REQUIRE_THROWS_AS(skipList.nextKey((NUMBER_OF_ELEMENTS - 1) * 2), std::out_of_range);
+    REQUIRE_THROWS_AS(skipList.previousKey(0), std::out_of_range);
+    REQUIRE_THROWS_AS(skipList.find(1), std::out_of_range);
+    REQUIRE_THROWS_AS(skipList.erase(1), std::out_of_range);
+    REQUIRE_FALSE(skipList.contains(1));
+    REQUIRE(skipList.lower_bound(NUMBER_OF_ELEMENTS * 2) == skipList.end());
+}
+
+TEST_CASE("SimdSkipList:ExtremeKeys:ExpectOrderedWithTheRest", "[SimdSkipList]") {
+    // The smallest key compares equal to the minus infinity entries
+    proj2::SimdSkipList<int64_t, unsigned> skipList;
+    std::map<int64_t, unsigned> reference;
+    const std::vector<int64_t> keys{std::numeric_limits<int64_t>::min(),
+                                    std::numeric_limits<int64_t>::max(),
+                                    -1,
+                                    0,
+                                    1,
+                                    std::numeric_limits<int64_t>::min() + 1};
+    for (unsigned i = 0; i < 2000; i++) {
+        reference.emplace(static_cast<int64_t>(i) * 1000 - 1000000, i);
+    }
+    for (size_t i = 0; i < keys.size(); i++) {
+        reference.emplace(keys[i], static_cast<unsigned>(i));
+    }
+    for (const auto& [key, value] : reference) {
+        REQUIRE(skipList.insert(key, value));
+    }
+
+    requireSameAsMap(skipList, reference);
+    REQUIRE(skipList.contains(std::numeric_limits<int64_t>::min()));
+    REQUIRE((*skipList.begin()).first == std::numeric_limits<int64_t>::min());
+    REQUIRE(skipList.nextKey(std::numeric_limits<int64_t>::min()) ==
+            std::numeric_limits<int64_t>::min() + 1);
+    skipList.erase(std::numeric_limits<int64_t>::min());
+    REQUIRE_FALSE(skipList.contains(std::numeric_limits<int64_t>::min()));
+    REQUIRE(skipList.lower_bound(std::numeric_limits<int64_t>::min()) == skipList.begin());
+}
+
+}  // namespace
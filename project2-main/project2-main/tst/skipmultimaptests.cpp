@@ -0,0 +1,145 @@
+#include <SkipMultiMap.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+template <typename Iterator>
+std::vector<std::pair<unsigned, unsigned>> entriesOf(Iterator first, Iterator last) {
+    std::vector<std::pair<unsigned, unsigned>> entries;
+    for (; first != last; ++first) {
+        entries.emplace_back((*first).first, (*first).second);
+    }
+    return entries;
+}
+
+TEST_CASE("SkipMultiMap:DuplicateKeys:ExpectInsertionOrder", "[SkipMultiMap]") {
+    proj2::SkipMultiMap<std::string, int> multiMap;
+    multiMap.insert("b", 1);
+    multiMap.insert("a", 2);
+    multiMap.insert("b", 3);
+    multiMap.insert("c", 4);
+    auto last = multiMap.insert("b", 5);
+    REQUIRE((*last).first == "b");
+    REQUIRE((*last).second == 5);
+
+    REQUIRE(multiMap.size() == 5);
+    REQUIRE(multiMap.keyCount() == 3);
+    REQUIRE(multiMap.count("b") == 3);
+    REQUIRE(multiMap.count("z") == 0);
+
+    std::vector<int> values;
+    auto [first, end] = multiMap.equal_range("b");
+    for (; first != end; ++first) {
+        values.push_back((*first).second);
+    }
+    REQUIRE(values == std::vector<int>{1, 3, 5});
+    REQUIRE((*end).first == "c");
+
+    auto [missingFirst, missingEnd] = multiMap.equal_range("bb");
+    REQUIRE(missingFirst == missingEnd);
+    REQUIRE(multiMap.find("bb") == multiMap.end());
+    REQUIRE((*multiMap.find("b")).second == 1);
+}
+
+TEST_CASE("SkipList:FindOrInsert:ExpectOneSearch", "[SkipMultiMap][SkipList]") {
+    proj2::SkipList<unsigned, unsigned, proj2::CountingSkipListTraits> skipList;
+    for (unsigned i = 0; i < 1000; i++) {
+        auto [position, inserted] = skipList.findOrInsert(i * 2, i);
+        REQUIRE(inserted);
+        REQUIRE((*position).first == i * 2);
+    }
+
+    skipList.resetStats();
+    REQUIRE(skipList.contains(500));
+    const uint64_t searchComparisons{skipList.stats().comparisons};
+    skipList.resetStats();
+    auto [position, inserted] = skipList.findOrInsert(500, 0);
+    REQUIRE_FALSE(inserted);
+    REQUIRE(skipList.stats().comparisons == searchComparisons);
+
+    skipList.mapped(position) = 46;
+    REQUIRE(skipList.find(500) == 46);
+    REQUIRE(skipList.size() == 1000);
+}
+
+TEST_CASE("SkipMultiMap:EraseKey:ExpectAllEntriesGone", "[SkipMultiMap]") {
+    proj2::SkipMultiMap<unsigned, unsigned> multiMap;
+    for (unsigned value = 0; value < 30; value++) {
+        multiMap.insert(value % 3, value);
+    }
+    REQUIRE(multiMap.erase(1) == 10);
+    REQUIRE(multiMap.erase(1) == 0);
+    REQUIRE(multiMap.size() == 20);
+    REQUIRE_FALSE(multiMap.contains(1));
+    REQUIRE(multiMap.count(2) == 10);
+}
+
+TEST_CASE("SkipMultiMap:EraseEntry:ExpectIteratorToNext", "[SkipMultiMap]") {
+    proj2::SkipMultiMap<unsigned, unsigned> multiMap;
+    multiMap.insert(1, 10);
+    multiMap.insert(1, 11);
+    multiMap.insert(1, 12);
+    multiMap.insert(2, 20);
+
+    // The middle value of a key, its last value, then a key's only value
+    auto next = multiMap.erase(++multiMap.find(1));
+    REQUIRE((*next).second == 12);
+    next = multiMap.erase(next);
+    REQUIRE((*next).first == 2);
+    next = multiMap.erase(next);
+    REQUIRE(next == multiMap.end());
+
+    REQUIRE(entriesOf(multiMap.begin(), multiMap.end()) ==
+            std::vector<std::pair<unsigned, unsigned>>{{1, 10}});
+    REQUIRE(multiMap.size() == 1);
+    REQUIRE(multiMap.keyCount() == 1);
+}
+
+TEST_CASE("SkipMultiMap:RandomOperations:ExpectSameAsStdMultimap", "[SkipMultiMap]") {
+    proj2::SkipMultiMap<unsigned, unsigned> multiMap;
+    std::multimap<unsigned, unsigned> reference;
+    std::mt19937 random{46};
+
+    for (unsigned step = 0; step < 10000; step++) {
+        auto key = static_cast<unsigned>(random() % 200);
+        switch (random() % 4) {
+            case 0:
+                REQUIRE(multiMap.erase(key) == reference.erase(key));
+                break;
+            case 1:
+                if (reference.count(key) != 0) {
+                    auto [first, last] = reference.equal_range(key);
+                    auto skip = random() % reference.count(key);
+                    auto position = multiMap.find(key);
+                    for (; skip > 0; skip--) {
+                        ++first;
+                        ++position;
+                    }
+                    multiMap.erase(position);
+                    reference.erase(first);
+                }
+                break;
+            default:
+                multiMap.insert(key, step);
+                reference.emplace(key, step);
+        }
+    }
+
+    REQUIRE(multiMap.size() == reference.size());
+    REQUIRE(entriesOf(multiMap.begin(), multiMap.end()) ==
+            entriesOf(reference.begin(), reference.end()));
+    for (unsigned key = 0; key < 200; key++) {
+        auto [first, last] = multiMap.equal_range(key);
+        auto [expectedFirst, expectedLast] = reference.equal_range(key);
+        REQUIRE(entriesOf(first, last) == entriesOf(expectedFirst, expectedLast));
+    }
+}
+
+}  // namespace
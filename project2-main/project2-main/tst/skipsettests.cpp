@@ -0,0 +1,96 @@
+#include <SkipSet.hpp>
+#include <algorithm>
+#include <catch2/catch_amalgamated.hpp>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+TEST_CASE("SkipSet:RandomOperations:ExpectSameAsStdSet", "[SkipSet]") {
+    proj2::SkipSet<unsigned> skipSet;
+    proj2::SkipList<unsigned, unsigned> skipList;
+    std::set<unsigned> reference;
+    std::mt19937 random{46};
+
+    for (int step = 0; step < 10000; step++) {
+        auto key = static_cast<unsigned>(random() % 1000);
+        if (random() % 3 == 0 and reference.count(key) != 0) {
+            skipSet.erase(key);
+            skipList.erase(key);
+            reference.erase(key);
+        } else {
+            REQUIRE(skipSet.insert(key) == reference.insert(key).second);
+            skipList.insert(key, key);
+        }
+    }
+
+    REQUIRE(skipSet.size() == reference.size());
+    REQUIRE(skipSet.layers() == skipList.layers());
+    REQUIRE(std::equal(skipSet.begin(), skipSet.end(), reference.begin(), reference.end()));
+    for (unsigned key : reference) {
+        REQUIRE(skipSet.contains(key));
+        REQUIRE(skipSet.height(key) == skipList.height(key));
+    }
+    REQUIRE_FALSE(skipSet.contains(1000));
+    REQUIRE_THROWS_AS(skipSet.erase(1000), std::out_of_range);
+}
+
+TEST_CASE("SkipSet:LowerBound:ExpectSmallestKeyNotLess", "[SkipSet]") {
+    proj2::SkipSet<std::string> skipSet;
+    for (const char* word : {"delta", "alpha", "charlie", "echo", "bravo"}) {
+        REQUIRE(skipSet.insert(word));
+    }
+    REQUIRE_FALSE(skipSet.insert("charlie"));
+
+    REQUIRE(*skipSet.lower_bound("c") == "charlie");
+    REQUIRE(*skipSet.lower_bound("charlie") == "charlie");
+    REQUIRE(skipSet.lower_bound("foxtrot") == skipSet.end());
+    REQUIRE(skipSet.lower_bound("b")->size() == 5);
+
+    std::vector<std::string> tail(skipSet.lower_bound("cz"), skipSet.end());
+    REQUIRE(tail == std::vector<std::string>{"delta", "echo"});
+    REQUIRE(skipSet.nextKey("alpha") == "bravo");
+    REQUIRE(skipSet.previousKey("echo") == "delta");
+}
+
+TEST_CASE("SkipSet:NodeBytes:ExpectNoRoomForValues", "[SkipSet]") {
+    // Even a bool would cost a string-keyed node 8 bytes of padding; a
+    // small key could hide it in padding the node has anyway
+    proj2::SkipSet<std::string> skipSet;
+    proj2::SkipList<std::string, bool> skipList;
+    for (unsigned key = 0; key < 200; key++) {
+        skipSet.insert(std::to_string(key));
+        skipList.insert(std::to_string(key), true);
+    }
+
+    auto setReport = skipSet.structureReport();
+    auto listReport = skipList.structureReport();
+    REQUIRE(setReport.nodeCount == listReport.nodeCount);
+    REQUIRE(setReport.nodeBytes < listReport.nodeBytes);
+    REQUIRE(setReport.valueHeapBytes == 0);
+}
+
+TEST_CASE("SkipSet:BuildFromSorted:ExpectSameAsInserting", "[SkipSet]") {
+    std::vector<unsigned> keys;
+    for (unsigned key = 0; key < 5000; key += 3) {
+        keys.push_back(key);
+    }
+    proj2::SkipSet<unsigned> built;
+    built.buildFromSorted(keys, 4);
+    proj2::SkipSet<unsigned> inserted;
+    for (unsigned key : keys) {
+        inserted.insert(key);
+    }
+
+    REQUIRE(built.allKeysInOrder() == keys);
+    REQUIRE(built.layers() == inserted.layers());
+    for (auto position = built.begin(); position != built.end(); ++position) {
+        REQUIRE(position.height() == inserted.height(*position));
+    }
+}
+
+}  // namespace
@@ -0,0 +1,131 @@
+#include <SkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+std::string snapshotPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST_CASE("SkipList:SaveLoadUnsigned:ExpectSameKeysValuesAndHeights",
+          "[SkipList][Snapshot]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 10000;
+    const unsigned MAGIC_VAL = 255;
+    const std::string PATH = snapshotPath("skiplist_unsigned.snap");
+
+    // Inserted out of order, so the heights are not those of a sorted build
+    proj2::SkipList<unsigned, unsigned> original;
+    original.insert(MAGIC_VAL, MAGIC_VAL);
+    for (unsigned i = NUMBER_OF_ELEMENTS; i > 0; i--) {
+        original.insert(i, i * 3);
+    }
+    REQUIRE(original.size() == NUMBER_OF_ELEMENTS);
+    original.save(PATH);
+
+    proj2::SkipList<unsigned, unsigned> loaded;
+    loaded.load(PATH);
+
+    REQUIRE(loaded.size() == original.size());
+    REQUIRE(loaded.layers() == original.layers());
+    REQUIRE(loaded.allKeysInOrder() == original.allKeysInOrder());
+    for (unsigned i = 1; i <= NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(loaded.height(i) == original.height(i));
+        REQUIRE(loaded.find(i) == (i == MAGIC_VAL ? MAGIC_VAL : i * 3));
+    }
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("SkipList:LoadIntoListThatOnceGrew:ExpectSnapshotLoaded", "[SkipList][Snapshot]") {
+    const std::string PATH = snapshotPath("skiplist_small.snap");
+
+    proj2::SkipList<unsigned, unsigned> small;
+    small.insert(7, 70);
+    small.insert(3, 30);
+    small.save(PATH);
+
+    // Emptied by erases, but still as tall as it was with 5000 keys
+    proj2::SkipList<unsigned, unsigned> loaded;
+    for (unsigned i = 0; i < 5000; i++) {
+        loaded.insert(i, i);
+    }
+    for (unsigned i = 0; i < 5000; i++) {
+        loaded.erase(i);
+    }
+    REQUIRE(loaded.layers() > small.layers());
+    const size_t tallLayers{loaded.layers()};
+
+    loaded.load(PATH);
+    REQUIRE(loaded.size() == 2);
+    REQUIRE(loaded.layers() == tallLayers);
+    REQUIRE(loaded.allKeysInOrder() == std::vector<unsigned>{3, 7});
+    REQUIRE(loaded.find(7) == 70);
+    REQUIRE(loaded.height(3) == small.height(3));
+    REQUIRE(loaded.insert(5, 50));
+    REQUIRE(loaded.nextKey(3) == 5);
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("SkipList:SaveLoadStringsWithoutHeights:ExpectSortedBuildShape",
+          "[SkipList][Snapshot]") {
+    const std::string PATH = snapshotPath("skiplist_strings.snap");
+
+    proj2::SkipList<std::string, std::string> original;
+    original.insert("TA", "OFFICEHOURS");
+    original.insert("BA", "SCHOOL");
+    original.insert("", "EMPTY");
+    original.save(PATH, false);
+
+    proj2::SkipList<std::string, std::string> loaded;
+    loaded.load(PATH);
+
+    proj2::SkipList<std::string, std::string> sorted;
+    sorted.insert("", "EMPTY");
+    sorted.insert("BA", "SCHOOL");
+    sorted.insert("TA", "OFFICEHOURS");
+
+    REQUIRE(loaded.allKeysInOrder() == original.allKeysInOrder());
+    REQUIRE(loaded.find("") == "EMPTY");
+    REQUIRE(loaded.find("TA") == "OFFICEHOURS");
+    REQUIRE(loaded.layers() == sorted.layers());
+    REQUIRE(loaded.height("BA") == sorted.height("BA"));
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("SkipList:LoadCorruptOrTruncatedSnapshot:ExpectThrowsAndStaysEmpty",
+          "[SkipList][Snapshot]") {
+    const std::string PATH = snapshotPath("skiplist_corrupt.snap");
+
+    proj2::SkipList<unsigned, unsigned> original;
+    for (unsigned i = 0; i < 100; i++) {
+        original.insert(i, i);
+    }
+    original.save(PATH);
+    const auto fileSize = std::filesystem::file_size(PATH);
+
+    {
+        std::fstream file{PATH, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(static_cast<std::streamoff>(fileSize / 2));
+        file.put('\x7f');
+    }
+    proj2::SkipList<unsigned, unsigned> corrupt;
+    REQUIRE_THROWS_AS(corrupt.load(PATH), std::runtime_error);
+    REQUIRE(corrupt.empty());
+    REQUIRE(corrupt.layers() == 2);
+
+    original.save(PATH);
+    std::filesystem::resize_file(PATH, fileSize - 1);
+    proj2::SkipList<unsigned, unsigned> truncated;
+    REQUIRE_THROWS_AS(truncated.load(PATH), std::runtime_error);
+    REQUIRE(truncated.empty());
+
+    REQUIRE_THROWS_AS(truncated.load(snapshotPath("skiplist_missing.snap")),
+                      std::runtime_error);
+    std::filesystem::remove(PATH);
+}
+
+}  // namespace
@@ -0,0 +1,92 @@
+#include <SkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+using CountingSkipList = proj2::SkipList<unsigned, unsigned, proj2::CountingSkipListTraits>;
+
+template <typename List>
+concept HasStats = requires(const List& list) { list.stats(); };
+
+TEST_CASE("SkipList:Stats:ExpectCompiledOutByDefault", "[SkipList][Stats]") {
+    STATIC_REQUIRE_FALSE(HasStats<proj2::SkipList<unsigned, unsigned>>);
+    STATIC_REQUIRE(HasStats<CountingSkipList>);
+
+    // Counting changes nothing about the list itself
+    proj2::SkipList<unsigned, unsigned> plain;
+    CountingSkipList counting;
+    for (unsigned i = 0; i < 100; i++) {
+        plain.insert(i, i);
+        counting.insert(i, i);
+    }
+    REQUIRE(counting.layers() == plain.layers());
+    for (unsigned i = 0; i < 100; i++) {
+        REQUIRE(counting.height(i) == plain.height(i));
+    }
+}
+
+TEST_CASE("SkipList:StatsInsert:ExpectOneNodePerLayerOfEachTower",
+          "[SkipList][Stats]") {
+    CountingSkipList skipList;
+    size_t towerNodes{0};
+    for (unsigned i = 0; i < 100; i++) {
+        skipList.insert(i, i);
+    }
+    for (unsigned i = 0; i < 100; i++) {
+        towerNodes += skipList.height(i);
+    }
+    REQUIRE_FALSE(skipList.insert(5, 5));
+
+    const proj2::SkipListStats& stats{skipList.stats()};
+    REQUIRE(stats.inserts == 101);
+    REQUIRE(stats.promotions == towerNodes - 100);
+    // Two sentinels for every layer beyond the initial two
+    REQUIRE(stats.nodesAllocated == towerNodes + 2 * (skipList.layers() - 2));
+    REQUIRE(stats.nodesFreed == 0);
+    REQUIRE(stats.comparisons > 0);
+}
+
+TEST_CASE("SkipList:StatsErase:ExpectWholeTowerFreed", "[SkipList][Stats]") {
+    CountingSkipList skipList;
+    for (unsigned i = 0; i < 100; i++) {
+        skipList.insert(i, i);
+    }
+    const size_t erasedHeight{skipList.height(7)};
+    skipList.resetStats();
+
+    skipList.erase(7);
+    REQUIRE(skipList.stats().erases == 1);
+    REQUIRE(skipList.stats().nodesFreed == erasedHeight);
+    REQUIRE(skipList.stats().nodesAllocated == 0);
+}
+
+TEST_CASE("SkipList:StatsLookup:ExpectLogarithmicHops", "[SkipList][Stats]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 4096;
+    CountingSkipList skipList;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.insert(i * 2, i);
+    }
+    skipList.resetStats();
+
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(skipList.find(i * 2) == i);
+        REQUIRE_FALSE(skipList.contains(i * 2 + 1));
+    }
+
+    // Misses stop at the first larger key rather than scanning the base
+    // layer, so both kinds of lookup stay far below a linear scan. The
+    // deterministic coin leaves long runs of short towers among these keys,
+    // so the bound is loose.
+    const proj2::SkipListStats& stats{skipList.stats()};
+    REQUIRE(stats.lookups == 2 * NUMBER_OF_ELEMENTS);
+    const double hops{static_cast<double>(stats.nextHops + stats.downHops) /
+                      static_cast<double>(stats.lookups)};
+    REQUIRE(hops > 0);
+    REQUIRE(hops < NUMBER_OF_ELEMENTS / 8);
+    REQUIRE(stats.downHops == stats.lookups * (skipList.layers() - 1));
+}
+
+}  // namespace
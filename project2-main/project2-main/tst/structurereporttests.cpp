@@ -0,0 +1,107 @@
+#include <SkipList.hpp>
+#include <algorithm>
+#include <catch2/catch_amalgamated.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+TEST_CASE("SkipList:StructureReportEmpty:ExpectTwoEmptyLayers",
+          "[SkipList][StructureReport]") {
+    proj2::SkipList<unsigned, unsigned> skipList;
+    proj2::SkipListReport report{skipList.structureReport()};
+
+    REQUIRE(report.size == 0);
+    REQUIRE(report.layers == 2);
+    REQUIRE(report.nodesPerLayer == std::vector<size_t>{0, 0});
+    REQUIRE(report.emptyLayers == 2);
+    REQUIRE(report.heightHistogram.empty());
+    REQUIRE(report.nodeCount == 4);
+    REQUIRE(report.bytesPerKey() == 0);
+    REQUIRE(report.toJson().starts_with("{\"size\": 0, \"layers\": 2,"));
+}
+
+TEST_CASE("SkipList:StructureReport:ExpectCountsMatchHeights",
+          "[SkipList][StructureReport]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 3000;
+    proj2::SkipList<unsigned, unsigned> skipList;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.insert(i, i);
+    }
+    proj2::SkipListReport report{skipList.structureReport()};
+
+    std::vector<size_t> nodesPerLayer(skipList.layers(), 0);
+    std::vector<size_t> heights;
+    size_t towerNodes{0};
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        size_t height{skipList.height(i)};
+        towerNodes += height;
+        if (heights.size() < height) {
+            heights.resize(height, 0);
+        }
+        heights[height - 1]++;
+        for (size_t layer = 0; layer < height; layer++) {
+            nodesPerLayer[layer]++;
+        }
+    }
+
+    REQUIRE(report.size == NUMBER_OF_ELEMENTS);
+    REQUIRE(report.layers == skipList.layers());
+    REQUIRE(report.nodesPerLayer == nodesPerLayer);
+    REQUIRE(report.heightHistogram == heights);
+    REQUIRE(report.expectedHeightHistogram.size() == heights.size());
+    REQUIRE(report.expectedHeightHistogram[0] == NUMBER_OF_ELEMENTS / 2.0);
+    REQUIRE(report.emptyLayers >= 1);
+    REQUIRE(report.nodeCount == towerNodes + 2 * skipList.layers());
+    REQUIRE(report.keyHeapBytes == 0);
+    REQUIRE(report.totalBytes() == report.nodeBytes);
+}
+
+TEST_CASE("SkipList:StructureReportSearchPath:ExpectSameAsCountedHops",
+          "[SkipList][StructureReport]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 2000;
+    proj2::SkipList<unsigned, unsigned, proj2::CountingSkipListTraits> skipList;
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.insert(i * 7, i);
+    }
+
+    size_t totalHops{0};
+    size_t maxHops{0};
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        skipList.resetStats();
+        REQUIRE(skipList.find(i * 7) == i);
+        size_t hops{skipList.stats().nextHops + skipList.stats().downHops};
+        totalHops += hops;
+        maxHops = std::max(maxHops, hops);
+    }
+    proj2::SkipListReport report{skipList.structureReport()};
+
+    REQUIRE(report.maxSearchPath == maxHops);
+    REQUIRE(report.averageSearchPath ==
+            Catch::Approx(static_cast<double>(totalHops) / NUMBER_OF_ELEMENTS));
+}
+
+TEST_CASE("SkipList:StructureReportDegenerateCoin:ExpectLargeHeightDeviation",
+          "[SkipList][StructureReport]") {
+    // Even keys below 256 always flip tails first, so every height is 1
+    proj2::SkipList<unsigned, std::string> degenerate;
+    for (unsigned i = 0; i < 128; i++) {
+        degenerate.insert(i * 2, std::string(64, 'v'));
+    }
+    proj2::SkipListReport report{degenerate.structureReport()};
+
+    REQUIRE(report.heightHistogram == std::vector<size_t>{128});
+    REQUIRE(report.heightDeviation == Catch::Approx(0.5));
+    REQUIRE(report.maxSearchPath == 127 + report.layers - 1);
+    REQUIRE(report.valueHeapBytes >= 128 * 65);
+    REQUIRE(report.toJson().find("\"height_deviation\": 0.5") != std::string::npos);
+
+    proj2::SkipList<unsigned, unsigned> mixed;
+    for (unsigned i = 0; i < 4096; i++) {
+        mixed.insert(i, i);
+    }
+    REQUIRE(mixed.structureReport().heightDeviation < 0.2);
+}
+
+}  // namespace
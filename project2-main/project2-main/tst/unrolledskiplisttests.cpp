@@ -0,0 +1,99 @@
+#include <UnrolledSkipList.hpp>
+#include <catch2/catch_amalgamated.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+TEST_CASE("UnrolledSkipList:InsertFind:ExpectSplitBlocksInOrder",
+          "[UnrolledSkipList]") {
+    const unsigned int NUMBER_OF_ELEMENTS = 5000;
+    proj2::UnrolledSkipList<unsigned, unsigned, 8> skipList;
+    std::vector<unsigned> expected;
+
+    // Descending inserts keep splitting the first block
+    for (unsigned i = NUMBER_OF_ELEMENTS; i-- > 0;) {
+        REQUIRE(skipList.insert(i * 3, i));
+        expected.insert(expected.begin(), i * 3);
+    }
+    REQUIRE_FALSE(skipList.insert(3, 100));
+
+    REQUIRE(skipList.size() == NUMBER_OF_ELEMENTS);
+    REQUIRE(skipList.allKeysInOrder() == expected);
+    REQUIRE(skipList.blockCount() >= NUMBER_OF_ELEMENTS / 8);
+    REQUIRE(skipList.layers() > 1);
+    for (unsigned i = 0; i < NUMBER_OF_ELEMENTS; i++) {
+        REQUIRE(skipList.find(i * 3) == i);
+        REQUIRE_FALSE(skipList.contains(i * 3 + 1));
+    }
+    REQUIRE_THROWS_AS(skipList.find(1), std::out_of_range);
+    REQUIRE(skipList.nextKey(21) == 24);
+    REQUIRE(skipList.previousKey(24) == 21);
+    REQUIRE_THROWS_AS(skipList.nextKey((NUMBER_OF_ELEMENTS - 1) * 3), std::out_of_range);
+    REQUIRE_THROWS_AS(skipList.previousKey(0), std::out_of_range);
+}
+
+TEST_CASE("UnrolledSkipList:RandomOperations:ExpectSameAsStdMap",
+          "[UnrolledSkipList]") {
+    proj2::UnrolledSkipList<unsigned, unsigned, 6> skipList;
+    std::map<unsigned, unsigned> reference;
+    std::mt19937 random{46};
+
+    for (int step = 0; step < 40000; step++) {
+        auto key = static_cast<unsigned>(random() % 2000);
+        if (random() % 3 == 0 and reference.count(key) != 0) {
+            skipList.erase(key);
+            reference.erase(key);
+        } else {
+            REQUIRE(skipList.insert(key, step) == reference.emplace(key, step).second);
+        }
+        if (step % 1000 == 0) {
+            std::vector<unsigned> keys;
+            for (const auto& [k, v] : reference) {
+                keys.push_back(k);
+            }
+            REQUIRE(skipList.allKeysInOrder() == keys);
+        }
+    }
+
+    REQUIRE(skipList.size() == reference.size());
+    for (const auto& [key, value] : reference) {
+        REQUIRE(skipList.find(key) == value);
+    }
+    for (const auto& [key, value] : reference) {
+        skipList.erase(key);
+    }
+    REQUIRE(skipList.empty());
+    REQUIRE(skipList.blockCount() == 1);
+    REQUIRE(skipList.begin() == skipList.end());
+}
+
+TEST_CASE("UnrolledSkipList:Scans:ExpectRangeInOrder", "[UnrolledSkipList]") {
+    proj2::UnrolledSkipList<std::string, unsigned> skipList;
+    for (unsigned i = 0; i < 1000; i++) {
+        skipList.insert("key" + std::to_string(1000 + i), i);
+    }
+
+    std::vector<unsigned> seen;
+    skipList.forEachInRange("key1100", "key1105x",
+                            [&seen](const std::string&, unsigned value) {
+                                seen.push_back(value);
+                            });
+    REQUIRE(seen == std::vector<unsigned>{100, 101, 102, 103, 104, 105});
+
+    auto it = skipList.lower_bound("key1998a");
+    REQUIRE((*it).first == "key1999");
+    REQUIRE(++it == skipList.end());
+
+    unsigned expected{0};
+    for (auto [key, value] : skipList) {
+        REQUIRE(value == expected++);
+    }
+    REQUIRE(expected == 1000);
+}
+
+}  // namespace
@@ -0,0 +1,211 @@
+#include <SkipList.hpp>
+#include <array>
+#include <catch2/catch_amalgamated.hpp>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+namespace proj2 = shindler::ics46::project2;
+
+// Counts every copy made of any Payload, so a test can see how many times
+// the skip list copied the values it was given
+struct Payload {
+    static inline size_t copies{0};
+    unsigned id{0};
+
+    Payload() = default;
+    explicit Payload(unsigned id) : id{id} {}
+    Payload(const Payload& other) : id{other.id} { copies++; }
+    Payload(Payload&&) noexcept = default;
+    Payload& operator=(const Payload& other) {
+        id = other.id;
+        copies++;
+        return *this;
+    }
+    Payload& operator=(Payload&&) noexcept = default;
+};
+
+// No default constructor, and a count of the instances alive, so a test
+// can see that sentinels build none and that every value is destroyed
+template <size_t BYTES>
+struct Tracked {
+    static inline long alive{0};
+    std::array<char, BYTES> bytes{};
+    unsigned id;
+
+    explicit Tracked(unsigned id) : id{id} { alive++; }
+    Tracked(const Tracked& other) : bytes{other.bytes}, id{other.id} { alive++; }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked() { alive--; }
+};
+
+struct OutOfLineTraits : proj2::SkipListTraits {
+    static constexpr size_t INLINE_VALUE_BYTES{0};
+};
+
+// Empty, but each key's is its own object
+struct Marker {
+    explicit Marker(unsigned) {}
+};
+
+TEST_CASE("SkipList:InsertValue:ExpectOneCopyWhateverTheHeight",
+          "[SkipList][ValueStorage]") {
+    proj2::SkipList<unsigned, Payload> skipList;
+    size_t towerNodes{0};
+    Payload::copies = 0;
+    for (unsigned i = 0; i < 500; i++) {
+        skipList.insert(i, Payload{i});
+    }
+    for (unsigned i = 0; i < 500; i++) {
+        towerNodes += skipList.height(i);
+    }
+
+    REQUIRE(towerNodes > 500);
+    REQUIRE(Payload::copies == 500);
+    REQUIRE(skipList.find(321).id == 321);
+}
+
+TEST_CASE("SkipList:StructureReportValues:ExpectEachValueCountedOnce",
+          "[SkipList][ValueStorage]") {
+    proj2::SkipList<unsigned, std::string> skipList;
+    size_t valueBytes{0};
+    for (unsigned i = 0; i < 300; i++) {
+        std::string value(100, static_cast<char>('a' + i % 26));
+        valueBytes += proj2::heapBytes(value);
+        skipList.insert(i, value);
+    }
+    const proj2::SkipListReport report{skipList.structureReport()};
+
+    REQUIRE(report.nodeCount > 300 + 2 * skipList.layers());
+    REQUIRE(report.valueHeapBytes == valueBytes);
+    // Index nodes are smaller than base nodes, which carry the value
+    REQUIRE(report.nodeBytes < report.nodeCount * (sizeof(unsigned) + sizeof(std::string) +
+                                                   4 * sizeof(void*)));
+}
+
+TEST_CASE("SkipList:SaveLoadValues:ExpectValuesFromBaseNodes",
+          "[SkipList][ValueStorage]") {
+    const std::string path{"valuestoragetests.snapshot"};
+    proj2::SkipList<std::string, std::string> saved;
+    for (unsigned i = 0; i < 1000; i++) {
+        saved.insert("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    saved.save(path);
+
+    proj2::SkipList<std::string, std::string> loaded;
+    loaded.load(path);
+    std::filesystem::remove(path);
+    for (auto [key, value] : loaded) {
+        REQUIRE(value == "value" + key.substr(3));
+        REQUIRE(loaded.height(key) == saved.height(key));
+    }
+    REQUIRE(loaded.size() == 1000);
+}
+
+TEST_CASE("SkipList:Sentinels:ExpectNoValueConstructed", "[SkipList][ValueStorage]") {
+    using Small = Tracked<8>;
+    {
+        proj2::SkipList<unsigned, Small> skipList;
+        REQUIRE(Small::alive == 0);
+        REQUIRE(skipList.begin() == skipList.end());
+
+        for (unsigned i = 0; i < 100; i++) {
+            skipList.insert(i, Small{i});
+        }
+        REQUIRE(Small::alive == 100);
+        skipList.erase(50);
+        REQUIRE(Small::alive == 99);
+        REQUIRE(skipList.find(51).id == 51);
+    }
+    REQUIRE(Small::alive == 0);
+}
+
+TEST_CASE("SkipList:EmptyValues:ExpectOnePerKey", "[SkipList][ValueStorage]") {
+    proj2::SkipList<unsigned, Marker> skipList;
+    for (unsigned i = 0; i < 100; i++) {
+        skipList.insert(i, Marker{i});
+    }
+    REQUIRE(&skipList.find(1) != &skipList.find(2));
+}
+
+TEST_CASE("SkipList:LargeValues:ExpectStoredOutOfLine", "[SkipList][ValueStorage]") {
+    using Large = Tracked<512>;
+    {
+        proj2::SkipList<unsigned, Large> large;
+        proj2::SkipList<unsigned, Large*> pointers;
+        for (unsigned i = 0; i < 1000; i++) {
+            large.insert(i, Large{i});
+            pointers.insert(i, nullptr);
+        }
+        for (unsigned i = 0; i < 1000; i += 3) {
+            large.erase(i);
+            pointers.erase(i);
+        }
+        for (unsigned i = 0; i < 1000; i += 3) {
+            large.insert(i, Large{i + 1000});
+            pointers.insert(i, nullptr);
+        }
+        REQUIRE(Large::alive == 1000);
+        REQUIRE(large.find(300).id == 1300);
+        REQUIRE(large.find(301).id == 301);
+
+        // A node holds a pointer to its value, so it is no bigger than a
+        // node that holds a pointer as its value
+        proj2::SkipListReport report{large.structureReport()};
+        REQUIRE(report.nodeBytes == pointers.structureReport().nodeBytes);
+        REQUIRE(report.valueHeapBytes == 1000 * sizeof(Large));
+    }
+    REQUIRE(Large::alive == 0);
+}
+
+TEST_CASE("SkipList:OutOfLineValuesBulkBuild:ExpectSameAsInline", "[SkipList][ValueStorage]") {
+    std::vector<std::pair<unsigned, unsigned>> entries;
+    for (unsigned i = 0; i < 20000; i++) {
+        entries.emplace_back(i * 2, i);
+    }
+    proj2::SkipList<unsigned, unsigned, OutOfLineTraits> outOfLine;
+    proj2::SkipList<unsigned, unsigned> inlined;
+    outOfLine.buildFromSorted(entries, 4);
+    inlined.buildFromSorted(entries, 4);
+
+    REQUIRE(outOfLine.allKeysInOrder() == inlined.allKeysInOrder());
+    for (auto [key, value] : outOfLine) {
+        REQUIRE(value == key / 2);
+        REQUIRE(outOfLine.height(key) == inlined.height(key));
+    }
+    outOfLine.find(10) = 46;
+    REQUIRE(outOfLine.find(10) == 46);
+
+    // Each build thread had an arena of its own; the list now frees and
+    // reuses their slots
+    for (unsigned i = 0; i < 20000; i += 2) {
+        outOfLine.erase(i * 2);
+    }
+    for (unsigned i = 0; i < 20000; i += 2) {
+        outOfLine.insert(i * 2, i);
+    }
+    REQUIRE(outOfLine.allKeysInOrder() == inlined.allKeysInOrder());
+    REQUIRE(outOfLine.find(40) == 20);
+}
+
+TEST_CASE("SkipList:OutOfLineValuesBulkBuildFails:ExpectEveryValueDestroyed",
+          "[SkipList][ValueStorage]") {
+    using Large = Tracked<512>;
+    {
+        std::vector<std::pair<unsigned, Large>> entries;
+        for (unsigned i = 0; i < 20000; i++) {
+            entries.emplace_back(i, Large{i});
+        }
+        // Only the last thread's slice is out of order
+        entries.back().first = 0;
+        proj2::SkipList<unsigned, Large> skipList;
+        REQUIRE_THROWS_AS(skipList.buildFromSorted(entries, 4), std::invalid_argument);
+        REQUIRE(Large::alive == 20000);
+        REQUIRE(skipList.empty());
+    }
+    REQUIRE(Large::alive == 0);
+}
+
+}  // namespace